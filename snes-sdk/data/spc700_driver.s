@@ -5,6 +5,7 @@
 ; - Simple tone generation (square wave)
 ; - Sound effect playback
 ; - Basic music playback
+; - Data reception into ARAM while running (RECEIVE, for sample streaming)
 ;
 ; Communication with the 65816 CPU happens via ports $F4-$F7 (APUIO0-3)
 ;
@@ -15,7 +16,7 @@
 ; - I/O ports for CPU communication
 ;
 ; Memory Map:
-;   $0000-$00EF   Zero page / Direct page
+;   $0000-$00EF   Zero page / Direct page ($00-$01: receive pointer)
 ;   $00F0-$00FF   I/O registers
 ;   $0100-$01FF   Stack page
 ;   $0200-$02FF   Driver variables
@@ -87,6 +88,9 @@ FIR    = $0F    ; FIR filter coefficients (0-7 at $0F, $1F, $2F, etc.)
 ; Driver Variables (in SPC700 RAM)
 ; ============================================================================
 
+; Zero page
+recv_ptr = $00              ; RECEIVE destination (word, from ports 2-3)
+
 .org $0200
 
 ; State variables
@@ -120,8 +124,10 @@ driver_start:
     ; Initialize DSP
     call init_dsp
 
-    ; Signal ready to CPU by writing 0 to port 0
+    ; Signal ready to CPU: port 0 = 0 (no command taken yet), then
+    ; port 1 = $AA (cmd::READY, polled by audio::init after the upload)
     mov CPUIO0, #$00
+    mov CPUIO1, #$AA
 
     ; Main loop
 main_loop:
@@ -130,21 +136,24 @@ main_loop:
     cmp A, drv_counter      ; Same as last acknowledged?
     beq main_loop           ; Yes, no new command
 
-    ; New command received - process it
-    mov drv_counter, A      ; Acknowledge by echoing counter
-    mov CPUIO0, A           ; Echo back to CPU
+    ; New command received - read its ports before echoing, since the CPU
+    ; may reuse them as soon as it sees the echo
+    mov drv_counter, A
+    mov A, CPUIO1           ; Get parameter
+    mov drv_param, A
+    movw YA, CPUIO2         ; Get address (RECEIVE)
+    movw recv_ptr, YA
+
+    mov A, drv_counter
+    mov CPUIO0, A           ; Acknowledge by echoing counter
 
-    ; Extract command and parameter
-    mov A, CPUIO0
-    lsr A                   ; Shift to get command nibble
+    ; Extract command nibble
+    lsr A
     lsr A
     lsr A
     lsr A
     mov drv_cmd, A
 
-    mov A, CPUIO1           ; Get parameter
-    mov drv_param, A
-
     ; Dispatch command
     mov A, drv_cmd
     cmp A, #$01             ; PLAY_SFX
@@ -161,6 +170,8 @@ main_loop:
     beq cmd_set_mus_vol
     cmp A, #$07             ; STOP_ALL
     beq cmd_stop_all
+    cmp A, #$08             ; RECEIVE
+    beq cmd_receive
 
     ; Unknown command, ignore
     bra main_loop
@@ -214,6 +225,45 @@ cmd_stop_all:
     mov current_music, #$00
     bra main_loop
 
+; ----------------------------------------------------------------------------
+; RECEIVE: copy drv_param bytes (a multiple of 3, below $80) to recv_ptr
+; Per group the CPU writes 3 bytes to ports 1-3 and their offset to port 0;
+; the offset is echoed once all three are read. The CPU ends by writing the
+; command byte back to port 0, which is echoed before returning.
+; ----------------------------------------------------------------------------
+
+cmd_receive:
+    mov Y, #$00
+@group:
+    cmp Y, drv_param
+    beq @end
+@wait:
+    cmp Y, CPUIO0           ; Next group's offset?
+    bne @wait
+    mov A, CPUIO1
+    mov [recv_ptr]+Y, A
+    inc Y
+    mov A, CPUIO2
+    mov [recv_ptr]+Y, A
+    inc Y
+    mov A, CPUIO3
+    dec Y
+    dec Y
+    mov CPUIO0, Y           ; Echo: ports read, the CPU may send the next group
+    inc Y
+    inc Y
+    mov [recv_ptr]+Y, A
+    inc Y
+    bra @group
+
+@end:
+    mov A, drv_counter
+@wait_end:
+    cmp A, CPUIO0           ; Command byte written back?
+    bne @wait_end
+    mov CPUIO0, A
+    jmp main_loop
+
 ; ----------------------------------------------------------------------------
 ; DSP Initialization
 ; ----------------------------------------------------------------------------
@@ -174,6 +174,7 @@ int main() {
     // Main loop
     for (;;) {
         wait_vblank();
+        audio::service();  // Send the next queued command once the APU is ready
         process_input();
         update_display();
     }
@@ -80,8 +80,8 @@ int main() {
         // Update sprite
         update_sprite(0, x, static_cast<u8>(y));
 
-        // Upload to OAM
-        ppu::sprites_upload();
+        // Upload to OAM (full: update_sprite bypasses dirty tracking)
+        ppu::sprites_upload(true);
 
         // Store previous state
         prev_joy = joy;
@@ -7,6 +7,14 @@
 //
 // This is a header-only implementation to avoid register pressure issues
 // with the W65816's limited register set (A, X, Y only).
+//
+// play_sfx() and the other commands are queued; audio::service() sends
+// them to the driver one at a time as it acknowledges each:
+//   audio::init();
+//   loop:
+//       audio::play_sfx(audio::SFX_COIN);
+//       wait_vblank();
+//       audio::service();
 
 #include "types.hpp"
 #include "hal.hpp"
@@ -45,6 +53,7 @@ namespace cmd {
     constexpr u8 SET_SFX_VOL = 0x05;  // Set SFX volume (APUIO1 = 0-127)
     constexpr u8 SET_MUS_VOL = 0x06;  // Set music volume (APUIO1 = 0-127)
     constexpr u8 STOP_ALL    = 0x07;  // Stop all audio
+    constexpr u8 RECEIVE     = 0x08;  // Copy data to ARAM (APUIO1 = bytes, APUIO2-3 = address)
     constexpr u8 READY       = 0xAA;  // Driver ready acknowledgement
 }
 
@@ -67,11 +76,15 @@ inline u8 read_apuio2() { return hal::read8(reg::APUIO2::address); }
 inline u8 read_apuio3() { return hal::read8(reg::APUIO3::address); }
 
 // ============================================================================
-// Simple command interface (no loops to avoid register pressure)
+// Raw commands
 // ============================================================================
 
-// Send a raw command to the APU (no handshaking - fire and forget)
-inline void send_raw_command(u8 cmd_nibble, u8 param) {
+// Write one command to the APU ports without waiting for it to be taken
+// A second command written before the driver echoes the first replaces it,
+// so game code should go through the queue below; while the queue is
+// waiting for an echo, raw commands would break its handshake.
+// Returns the byte written to APUIO0 (the driver echoes it back)
+inline u8 send_raw_command(u8 cmd_nibble, u8 param) {
     // Increment command counter (used by SPC700 driver to detect new commands)
     // Counter wraps 1→255→1, avoiding 0 which indicates "no command"
     g_audio_command_counter = g_audio_command_counter + 1;
@@ -80,8 +93,545 @@ inline void send_raw_command(u8 cmd_nibble, u8 param) {
     write_apuio1(param);
     u8 cmd_byte = (cmd_nibble << 4) | (g_audio_command_counter & 0x0F);
     write_apuio0(cmd_byte);
+    return cmd_byte;
+}
+
+// ============================================================================
+// Command Queue
+// ============================================================================
+//
+// The driver takes one command at a time: it echoes each new APUIO0 byte
+// back on APUIO0 before looking for the next. service() sends a queued
+// command only once the previous one has been echoed, and returns at once
+// when it has not, so the CPU never spins on the APU. Commands that would
+// be redundant by the time they are sent are merged while they wait:
+//   - the same command with the same parameter (one coin sound, not ten)
+//   - volume changes of the same kind (the last value wins)
+//   - music changes (PLAY_MUSIC/STOP_MUSIC, the last one wins)
+//   - STOP_ALL discards pending sound effect and music commands
+
+constexpr u8 QUEUE_SIZE = 8;  // Pending commands (power of two)
+
+// Command priorities: the queue sends higher priorities first, and when
+// it is full a command only gets in by displacing one of lower priority
+namespace priority {
+    constexpr u8 LOW    = 0;  // Cosmetic sounds that may be lost
+    constexpr u8 NORMAL = 1;  // Sound effects (default)
+    constexpr u8 HIGH   = 2;  // Music, volume and stop commands
+}
+
+// Ring of pending commands, oldest first
+// Plain data with no constructor: call reset() before first use
+struct CommandQueue {
+    u8 op[QUEUE_SIZE];     // Command nibble (cmd::)
+    u8 param[QUEUE_SIZE];  // APUIO1 value
+    u8 prio[QUEUE_SIZE];
+    u8 head;               // Slot of the oldest command
+    u8 count;
+    u8 last_sent;          // APUIO0 byte awaiting its echo
+    bool waiting;          // last_sent not echoed yet
+    u8 dropped;            // Commands lost to a full queue (saturates)
+    u8 busy;               // service() calls that found the APU busy (saturates)
+
+    void reset() {
+        head = 0;
+        count = 0;
+        last_sent = 0;
+        waiting = false;
+        dropped = 0;
+        busy = 0;
+    }
+
+    // Queue a command, merging it with a pending one where possible
+    // Returns false if it was dropped (queue full of equal or higher priority)
+    bool push(u8 op_nibble, u8 value, u8 level = priority::NORMAL) {
+        if (op_nibble == cmd::STOP_ALL) discard_playback();
+
+        u8 group = merge_group(op_nibble);
+        for (u8 i = 0; i < count; i++) {
+            u8 s = slot(i);
+            bool same = op[s] == op_nibble && param[s] == value;
+            if (same || (group != cmd::NOP && merge_group(op[s]) == group)) {
+                op[s] = op_nibble;
+                param[s] = value;
+                if (level > prio[s]) prio[s] = level;
+                return true;
+            }
+        }
+
+        if (count == QUEUE_SIZE) {
+            // Displace the newest command of the lowest priority
+            u8 victim = static_cast<u8>(count - 1);
+            for (u8 i = count - 1; i-- > 0;) {
+                if (prio[slot(i)] < prio[slot(victim)]) victim = i;
+            }
+            if (dropped != 0xFF) dropped++;
+            if (prio[slot(victim)] >= level) return false;
+            remove(victim);
+        }
+
+        u8 s = slot(count++);
+        op[s] = op_nibble;
+        param[s] = value;
+        prio[s] = level;
+        return true;
+    }
+
+    // Send the next command if the APU has taken the previous one
+    // Never waits; call once per frame. Returns true if a command was sent.
+    bool service() {
+        if (!acknowledged() || count == 0) return false;
+
+        // Highest priority, oldest first among equals
+        u8 next = 0;
+        for (u8 i = 1; i < count; i++) {
+            if (prio[slot(i)] > prio[slot(next)]) next = i;
+        }
+        u8 s = slot(next);
+        last_sent = send_raw_command(op[s], param[s]);
+        waiting = true;
+        remove(next);
+        return true;
+    }
+
+    // Whether the APU has taken the last command (never waits)
+    bool acknowledged() {
+        if (waiting) {
+            if (read_apuio0() != last_sent) {
+                if (busy != 0xFF) busy++;
+                return false;
+            }
+            waiting = false;
+        }
+        return true;
+    }
+
+    // Nothing queued and the last command echoed
+    bool idle() const { return count == 0 && !waiting; }
+
+private:
+    u8 slot(u8 index) const { return static_cast<u8>((head + index) & (QUEUE_SIZE - 1)); }
+
+    // Commands where only the latest of a group matters (NOP = no group)
+    static u8 merge_group(u8 op_nibble) {
+        switch (op_nibble) {
+            case cmd::PLAY_MUSIC:
+            case cmd::STOP_MUSIC:
+                return cmd::PLAY_MUSIC;
+            case cmd::SET_VOLUME:
+            case cmd::SET_SFX_VOL:
+            case cmd::SET_MUS_VOL:
+                return op_nibble;
+            default:
+                return cmd::NOP;
+        }
+    }
+
+    // Remove the command at queue position index, keeping the order
+    void remove(u8 index) {
+        if (index == 0) {
+            head = slot(1);
+        } else {
+            for (u8 i = index; i + 1 < count; i++) {
+                u8 s = slot(i);
+                u8 n = slot(static_cast<u8>(i + 1));
+                op[s] = op[n];
+                param[s] = param[n];
+                prio[s] = prio[n];
+            }
+        }
+        count--;
+    }
+
+    // Drop pending sound effect and music commands (STOP_ALL supersedes them)
+    void discard_playback() {
+        for (u8 i = count; i-- > 0;) {
+            u8 o = op[slot(i)];
+            if (o == cmd::PLAY_SFX || o == cmd::PLAY_MUSIC || o == cmd::STOP_MUSIC) remove(i);
+        }
+    }
+};
+
+#ifdef SNES_TESTING
+// For unit tests, this is defined in src/audio.cpp
+extern CommandQueue g_queue;
+#else
+inline CommandQueue g_queue;
+#endif
+
+// ============================================================================
+// Background Streaming
+// ============================================================================
+//
+// Copies data (e.g. an instrument bank's BRR samples and its directory
+// entries) into ARAM while the game runs, using the CPU time it would
+// otherwise spend waiting for VBlank. Data goes in chunks with the
+// driver's RECEIVE command: APUIO1-3 carry three bytes and APUIO0 their
+// offset, echoed once read, and the chunk ends by writing the command
+// byte back to APUIO0. Offsets stay below $80 so they never look like a
+// RECEIVE command byte ($8x).
+//
+// service() never waits for the driver. Each call takes the stream as
+// far as the driver's echoes allow and returns at the first one still
+// outstanding, so calling it from the VBlank wait loop moves a group
+// every ~65 SPC700 cycles of idle time, a few hundred bytes to a few KB
+// a frame. New chunks only start on calls with no queued command to send.
+//
+// While a chunk is open the driver does nothing but wait for its groups;
+// its timers keep counting and music catches up once the chunk closes,
+// so keep calling service() until streaming() turns false.
+// Samples being overwritten must not be playing.
+//
+//   audio::stream(0x9000, forest_bank, sizeof(forest_bank));
+//   loop:
+//       update_game();
+//       u16 frame = vblank::frame_count();
+//       while (vblank::frame_count() == frame) audio::service();
+//   if (!audio::streaming()) ...       // bank ready
+
+constexpr u8 STREAM_CHUNK = 126;    // Bytes per RECEIVE command (42 groups)
+constexpr u16 STREAM_BUDGET = 2 * STREAM_CHUNK;  // Most bytes per service() call
+
+// Plain data with no constructor: call reset() before first use
+struct Stream {
+    // Where send() is within a chunk
+    static constexpr u8 IDLE = 0;     // Between chunks
+    static constexpr u8 OPENING = 1;  // RECEIVE sent, awaiting its echo
+    static constexpr u8 GROUPS = 2;   // Sending groups
+    static constexpr u8 CLOSING = 3;  // Command byte written back, awaiting its echo
+
+    const u8* data;
+    u16 aram;
+    u16 size;
+    u16 sent;              // Bytes in chunks already opened
+    u16 budget;            // Most bytes per send() call
+    const u8* chunk_src;   // Data of the open chunk
+    u8 chunk_bytes;        // Size of the open chunk
+    u8 offset;             // Next group within the open chunk
+    u8 cmd_byte;           // RECEIVE command byte of the open chunk
+    u8 expect;             // APUIO0 echo awaited
+    u8 phase;
+
+    // Forget any stream without talking to the driver (after an upload)
+    void reset() {
+        data = nullptr;
+        size = 0;
+        sent = 0;
+        phase = IDLE;
+    }
+
+    // Start copying size bytes (at least 3) to aram
+    // A chunk still open from the previous stream is finished first
+    bool begin(u16 dest, const u8* src, u16 bytes, u16 per_call = STREAM_BUDGET) {
+        if (bytes < 3) return false;
+        data = src;
+        aram = dest;
+        size = bytes;
+        sent = 0;
+        budget = per_call;
+        return true;
+    }
+
+    // Stop after the open chunk, if any
+    void cancel() { size = sent; }
+
+    bool active() const { return sent < size || phase != IDLE; }
+
+    // A chunk is open in the driver (commands must wait for it)
+    bool in_chunk() const { return phase != IDLE; }
+
+    // Move the stream on as far as the driver has answered, up to budget
+    // bytes; never waits. Returns the number of bytes sent.
+    u16 send(CommandQueue& queue) {
+        u16 total = 0;
+        for (;;) {
+            if (phase != IDLE && read_apuio0() != expect) break;
+
+            if (phase == IDLE) {
+                if (sent >= size || total >= budget || queue.count != 0 ||
+                    !queue.acknowledged()) {
+                    break;
+                }
+                open_chunk();
+            } else if (phase == CLOSING) {
+                queue.last_sent = cmd_byte;
+                phase = IDLE;
+            } else if (offset == chunk_bytes) {
+                write_apuio0(cmd_byte);
+                expect = cmd_byte;
+                phase = CLOSING;
+            } else {
+                if (total >= budget) break;
+                const u8* p = chunk_src + offset;
+                hal::write16(reg::APUIO2::address, static_cast<u16>(p[1] | (p[2] << 8)));
+                hal::write16(reg::APUIO0::address, static_cast<u16>(offset | (p[0] << 8)));
+                expect = offset;
+                offset = static_cast<u8>(offset + 3);
+                phase = GROUPS;
+                total = static_cast<u16>(total + 3);
+            }
+        }
+        return total;
+    }
+
+private:
+    // Send RECEIVE for the next chunk
+    // The last group overlaps bytes already sent when size is not a
+    // multiple of 3, so nothing past the region is written
+    void open_chunk() {
+        u16 start = sent;
+        u16 left = static_cast<u16>(size - start);
+        if (left < 3) {
+            start = static_cast<u16>(size - 3);
+            left = 3;
+        }
+        u8 bytes = STREAM_CHUNK;
+        if (left < STREAM_CHUNK) {
+            bytes = 0;
+            while (static_cast<u16>(bytes + 3) <= left) bytes = static_cast<u8>(bytes + 3);
+        }
+
+        hal::write16(reg::APUIO2::address, static_cast<u16>(aram + start));
+        cmd_byte = send_raw_command(cmd::RECEIVE, bytes);
+        expect = cmd_byte;
+        chunk_src = data + start;
+        chunk_bytes = bytes;
+        offset = 0;
+        phase = OPENING;
+        sent = static_cast<u16>(start + bytes);
+    }
+};
+
+#ifdef SNES_TESTING
+// For unit tests, this is defined in src/audio.cpp
+extern Stream g_stream;
+#else
+inline Stream g_stream;
+#endif
+
+// Start streaming bytes to aram in the background (replaces any stream
+// in progress once its open chunk is done). Returns false if size is
+// below 3.
+inline bool stream(u16 aram, const u8* data, u16 size, u16 per_call = STREAM_BUDGET) {
+    return g_stream.begin(aram, data, size, per_call);
+}
+
+inline bool streaming() {
+    return g_stream.active();
+}
+
+// Send the next queued command if the APU is ready, or else move the
+// stream on (an open chunk always goes first). Never waits: call it once
+// per frame, and from idle loops while streaming.
+// Returns true if a command or stream data was sent.
+inline bool service() {
+    if (g_stream.in_chunk() || (g_queue.count == 0 && g_stream.active())) {
+        return g_stream.send(g_queue) != 0;
+    }
+    return g_queue.service();
+}
+
+// ============================================================================
+// Driver Upload
+// ============================================================================
+//
+// After reset the SPC700 runs its IPL ROM, which takes data one byte per
+// handshake: the CPU writes a byte and its index and waits for the index
+// to be echoed. upload() uses it only for a 92-byte loader (below), then
+// streams through the loader three bytes per handshake (APUIO1-3, with
+// APUIO0 as the handshake), which cuts the SPC700 time per byte from about
+// 25 cycles to 16, and overlaps the CPU's writes with the loader's stores.
+//
+// Blocking: run it during forced blank, before enabling NMI.
+//
+//   const audio::ipl::Block image[] = {
+//       {0x0200, driver_bin, sizeof(driver_bin)},
+//       {0x8000, samples_brr, sizeof(samples_brr)},
+//   };
+//   audio::init(image, 2, 0x0300);
+
+namespace ipl {
+
+constexpr u16 LOADER_ADDR = 0x0100;  // Bottom of the stack page (stack is at $01EF down)
+constexpr u8 MAX_GROUPS = 85;        // 3-byte groups per loader header (255 bytes)
+
+// Data for one ARAM region; size must be at least 3
+struct Block {
+    u16 aram;
+    const u8* data;
+    u16 size;
+};
+
+namespace detail {
+
+// SPC700 loader, run from LOADER_ADDR
+// Header: APUIO1 = byte count (a multiple of 3, at most 255; 0 = jump to
+// the address), APUIO2-3 = address, then APUIO0 = HEADER. Data: APUIO1-3 =
+// 3 bytes, then APUIO0 = their offset from the header's address. Each
+// APUIO0 value is echoed once the ports have been read. The header patches
+// the address into the three stores, so the loop runs 48 cycles per group.
+constexpr u8 HEADER = 0xFF;
+
+inline constexpr u8 loader[] = {
+    0x78, 0xFF, 0xF4,  // hdr:  cmp $F4,#$FF      ; header: APUIO0 = $FF
+    0xD0, 0xFB,        //       bne hdr
+    0xE4, 0xF5,        //       mov a,$F5         ; byte count, 0 = jump
+    0xF0, 0x44,        //       beq exec
+    0xC5, 0x48, 0x01,  //       mov !end+1,a
+    0xBA, 0xF6,        //       movw ya,$F6       ; address
+    0xC5, 0x36, 0x01,  //       mov !st0+1,a
+    0xCC, 0x37, 0x01,  //       mov !st0+2,y
+    0xDA, 0x00,        //       movw $00,ya
+    0x3A, 0x00,        //       incw $00
+    0xBA, 0x00,        //       movw ya,$00
+    0xC5, 0x3B, 0x01,  //       mov !st1+1,a
+    0xCC, 0x3C, 0x01,  //       mov !st1+2,y
+    0x3A, 0x00,        //       incw $00
+    0xBA, 0x00,        //       movw ya,$00
+    0xC5, 0x42, 0x01,  //       mov !st2+1,a
+    0xCC, 0x43, 0x01,  //       mov !st2+2,y
+    0x8D, 0x00,        //       mov y,#$00
+    0x8F, 0xFF, 0xF4,  //       mov $F4,#$FF      ; echo header
+    0x7E, 0xF4,        // loop: cmp y,$F4         ; data: APUIO0 = offset
+    0xD0, 0xFC,        //       bne loop
+    0xE4, 0xF5,        //       mov a,$F5
+    0xD6, 0x00, 0x00,  // st0:  mov !$0000+y,a    ; address patched
+    0xE4, 0xF6,        //       mov a,$F6
+    0xD6, 0x00, 0x00,  // st1:  mov !$0001+y,a
+    0xE4, 0xF7,        //       mov a,$F7
+    0xCB, 0xF4,        //       mov $F4,y         ; echo: ports read, CPU may write
+    0xD6, 0x00, 0x00,  // st2:  mov !$0002+y,a
+    0xFC,              //       inc y
+    0xFC,              //       inc y
+    0xFC,              //       inc y
+    0xAD, 0x00,        // end:  cmp y,#$00        ; byte count patched
+    0xD0, 0xE4,        //       bne loop
+    0x2F, 0xB3,        //       bra hdr
+    0xBA, 0xF6,        // exec: movw ya,$F6
+    0xDA, 0x00,        //       movw $00,ya
+    0x8F, 0x30, 0xF1,  //       mov $F1,#$30      ; clear input ports, IPL ROM off
+    0x8F, 0xFF, 0xF4,  //       mov $F4,#$FF      ; echo
+    0xCD, 0x00,        //       mov x,#$00
+    0x1F, 0x00, 0x00,  //       jmp [!$0000+x]
+};
+
+// Data bytes go out in a 16-bit store with the index/offset in APUIO0.
+// APUIO1 lands one bus cycle after APUIO0, and both the IPL ROM and the
+// loader read it at least 5 SPC700 cycles after they see APUIO0 change.
+
+inline void wait_port0(u8 value) {
+    while (read_apuio0() != value) {}
+}
+
+// IPL ROM ready signature
+inline void wait_ipl() {
+    while (read_apuio0() != 0xAA || read_apuio1() != 0xBB) {}
+}
+
+// IPL transfer of one block, one byte per handshake
+// kick: 0xCC for the first command after reset, else the previous return
+// value. Returns the kick for the next IPL command.
+inline u8 ipl_write(u8 kick, u16 aram, const u8* data, u16 size) {
+    hal::write16(reg::APUIO2::address, aram);
+    write_apuio1(1);
+    write_apuio0(kick);
+    wait_port0(kick);
+
+    for (u16 i = 0; i < size; i++) {
+        u8 index = static_cast<u8>(i);
+        hal::write16(reg::APUIO0::address, static_cast<u16>(index | (data[i] << 8)));
+        wait_port0(index);
+    }
+
+    // The next command must be 2-127 past the last index, and non-zero
+    u8 next = static_cast<u8>(size + 1);
+    return next == 0 ? 1 : next;
+}
+
+// IPL jump to aram
+inline void ipl_exec(u8 kick, u16 aram) {
+    hal::write16(reg::APUIO2::address, aram);
+    write_apuio1(0);
+    write_apuio0(kick);
+    wait_port0(kick);
+}
+
+// Loader header: the next bytes go to aram (bytes = 0: jump to aram)
+inline void loader_header(u16 aram, u8 bytes) {
+    hal::write16(reg::APUIO2::address, aram);
+    write_apuio1(bytes);
+    write_apuio0(HEADER);
+    wait_port0(HEADER);
 }
 
+// One 3-byte group: data in APUIO1-3, offset in APUIO0, then the echo
+inline void loader_group(const u8* p, u8 offset) {
+    hal::write16(reg::APUIO2::address, static_cast<u16>(p[1] | (p[2] << 8)));
+    hal::write16(reg::APUIO0::address, static_cast<u16>(offset | (p[0] << 8)));
+    wait_port0(offset);
+}
+
+// Stream one block through the loader
+// A size that is not a multiple of 3 ends with a group overlapping bytes
+// already sent, so nothing past the block is written.
+inline void loader_write(const Block& block) {
+    u16 done = 0;
+    while (done < block.size) {
+        u16 left = static_cast<u16>(block.size - done);
+        if (left < 3) {
+            done = static_cast<u16>(block.size - 3);
+            left = 3;
+        }
+        u16 whole = static_cast<u16>(left / 3);
+        u8 groups = whole > MAX_GROUPS ? MAX_GROUPS : static_cast<u8>(whole);
+        u8 bytes = static_cast<u8>(groups * 3);
+        loader_header(static_cast<u16>(block.aram + done), bytes);
+
+        // Three bytes per handshake in two stores, four groups per
+        // iteration with constant offsets, then the remaining 0-3
+        const u8* p = block.data + done;
+        u8 offset = 0;
+        for (u8 quads = static_cast<u8>(groups >> 2); quads != 0; quads--) {
+            loader_group(p, offset);
+            loader_group(p + 3, static_cast<u8>(offset + 3));
+            loader_group(p + 6, static_cast<u8>(offset + 6));
+            loader_group(p + 9, static_cast<u8>(offset + 9));
+            p += 12;
+            offset = static_cast<u8>(offset + 12);
+        }
+        for (u8 rest = static_cast<u8>(groups & 3); rest != 0; rest--) {
+            loader_group(p, offset);
+            p += 3;
+            offset = static_cast<u8>(offset + 3);
+        }
+        done = static_cast<u16>(done + bytes);
+    }
+}
+
+} // namespace detail
+
+// Copy blocks into ARAM and start the code at entry
+// Must run straight after reset, while the IPL ROM is waiting. Blocks must
+// not overlap the loader (LOADER_ADDR, 92 bytes) or zero page $00-$01.
+// Returns false, sending nothing, if a block is shorter than 3 bytes.
+inline bool upload(const Block* blocks, u8 count, u16 entry) {
+    for (u8 i = 0; i < count; i++) {
+        if (blocks[i].size < 3) return false;
+    }
+
+    detail::wait_ipl();
+    u8 kick = detail::ipl_write(0xCC, LOADER_ADDR, detail::loader, sizeof(detail::loader));
+    detail::ipl_exec(kick, LOADER_ADDR);
+
+    for (u8 i = 0; i < count; i++) {
+        detail::loader_write(blocks[i]);
+    }
+    detail::loader_header(entry, 0);
+    return true;
+}
+
+} // namespace ipl
+
 // ============================================================================
 // Initialization
 // ============================================================================
@@ -94,9 +644,19 @@ inline bool init() {
     g_audio_initialized = 1;
     g_audio_master_volume = 127;
     g_audio_command_counter = 0;
+    g_queue.reset();  // The driver starts by writing 0 to APUIO0
+    g_stream.reset();
     return true;
 }
 
+// Upload the driver and its data (see ipl::upload), wait for the driver to
+// signal READY on APUIO1, then initialize
+inline bool init(const ipl::Block* blocks, u8 count, u16 entry) {
+    if (!ipl::upload(blocks, count, entry)) return false;
+    while (read_apuio1() != cmd::READY) {}
+    return init();
+}
+
 // Check if audio system is initialized
 inline bool is_ready() {
     return g_audio_initialized != 0;
@@ -106,15 +666,15 @@ inline bool is_ready() {
 // Sound Effects
 // ============================================================================
 
-// Play a sound effect
-inline void play_sfx(u8 sfx) {
+// Play a sound effect (queued; see service())
+inline void play_sfx(u8 sfx, u8 level = priority::NORMAL) {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::PLAY_SFX, sfx);
+    g_queue.push(cmd::PLAY_SFX, sfx, level);
 }
 
 // Play a sound effect (type-safe version)
-inline void play_sfx(SoundEffect sfx) {
-    play_sfx(static_cast<u8>(sfx));
+inline void play_sfx(SoundEffect sfx, u8 level = priority::NORMAL) {
+    play_sfx(static_cast<u8>(sfx), level);
 }
 
 // ============================================================================
@@ -124,7 +684,7 @@ inline void play_sfx(SoundEffect sfx) {
 // Play a music track
 inline void play_music(u8 track) {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::PLAY_MUSIC, track);
+    g_queue.push(cmd::PLAY_MUSIC, track, priority::HIGH);
 }
 
 // Play a music track (type-safe version)
@@ -135,7 +695,7 @@ inline void play_music(MusicTrack track) {
 // Stop the currently playing music
 inline void stop_music() {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::STOP_MUSIC, 0);
+    g_queue.push(cmd::STOP_MUSIC, 0, priority::HIGH);
 }
 
 // ============================================================================
@@ -147,7 +707,7 @@ inline void set_master_volume(u8 volume) {
     if (g_audio_initialized == 0) return;
     u8 vol = volume & 0x7F;
     g_audio_master_volume = vol;
-    send_raw_command(cmd::SET_VOLUME, vol);
+    g_queue.push(cmd::SET_VOLUME, vol, priority::HIGH);
 }
 
 // Get current master volume
@@ -158,13 +718,13 @@ inline u8 get_master_volume() {
 // Set sound effects volume (0-127)
 inline void set_sfx_volume(u8 volume) {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::SET_SFX_VOL, volume & 0x7F);
+    g_queue.push(cmd::SET_SFX_VOL, volume & 0x7F, priority::HIGH);
 }
 
 // Set music volume (0-127)
 inline void set_music_volume(u8 volume) {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::SET_MUS_VOL, volume & 0x7F);
+    g_queue.push(cmd::SET_MUS_VOL, volume & 0x7F, priority::HIGH);
 }
 
 // ============================================================================
@@ -174,7 +734,7 @@ inline void set_music_volume(u8 volume) {
 // Stop all audio (music and sound effects)
 inline void stop_all() {
     if (g_audio_initialized == 0) return;
-    send_raw_command(cmd::STOP_ALL, 0);
+    g_queue.push(cmd::STOP_ALL, 0, priority::HIGH);
 }
 
 } // namespace audio
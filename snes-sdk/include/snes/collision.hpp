@@ -0,0 +1,212 @@
+#pragma once
+
+// SNES Collision API - Broadphase grid and tile-map collision for Rect
+//
+// Grid buckets rectangles into square cells, so overlap tests only run
+// between objects that share a cell instead of between every pair. It is
+// rebuilt from scratch each frame: clear() is one pass over the cell heads
+// and insert() touches only the cells a rectangle covers, so the rebuild
+// cost is bounded by the entry capacity.
+//
+//   collision::Grid<16, 14, 4, 192> grid;   // 16x14 cells of 16px
+//   grid.clear();
+//   for each object: grid.insert(id, object_rect);
+//   grid.for_each_pair([](u8 a, u8 b) { hit(a, b); });
+//
+// TileMap answers "does this rectangle touch a solid tile" against a
+// bit-packed collision layer (one bit per 8x8 tile).
+
+#include "types.hpp"
+
+namespace snes::collision {
+
+// End of a cell's entry list
+constexpr u8 NO_ENTRY = 0xFF;
+
+// Work done since the last clear(), for profiling
+struct Stats {
+    u16 entries;     // Cell entries used by insert()
+    u16 rect_tests;  // Rect overlap tests by query() and for_each_pair()
+    u16 pairs;       // Overlapping pairs reported
+};
+
+// Cols x Rows cells of (1 << CellShift) pixels, starting at the origin
+// MaxEntries: total object-in-cell entries (an object covering 4 cells uses
+// 4); object ids must be below MaxEntries
+// Plain data with no constructor: call reset() before first use
+template<u8 Cols, u8 Rows, u8 CellShift, u8 MaxEntries>
+struct Grid {
+    static_assert(static_cast<u16>(Cols) * Rows <= 1024, "Collision grid too large");
+    static_assert(MaxEntries >= 1 && MaxEntries < NO_ENTRY, "Grid entry capacity must be 1-254");
+
+    static constexpr u16 CELLS = static_cast<u16>(Cols) * Rows;
+
+    i16 origin_x;  // World position of cell (0, 0)
+    i16 origin_y;
+    u8 head[CELLS];               // First entry per cell
+    u8 entry_id[MaxEntries];      // Object of each entry
+    u8 entry_next[MaxEntries];    // Next entry in the same cell
+    u8 entry_count;
+    Rect rect[MaxEntries];        // Bounds of each inserted object
+    u8 seen[MaxEntries];          // Query stamps, for de-duplication
+    u8 stamp;
+    Stats stats;
+
+    void reset(i16 x = 0, i16 y = 0) {
+        origin_x = x;
+        origin_y = y;
+        for (u8 i = 0; i < MaxEntries; i++) seen[i] = 0;
+        stamp = 0;
+        clear();
+    }
+
+    // Empty every cell (call once per frame before inserting)
+    void clear() {
+        for (u16 i = 0; i < CELLS; i++) head[i] = NO_ENTRY;
+        entry_count = 0;
+        stats.entries = 0;
+        stats.rect_tests = 0;
+        stats.pairs = 0;
+    }
+
+    // Add object id with bounds r to every cell r covers (clamped to the grid)
+    // Returns false, inserting nothing, if the entries would run out
+    bool insert(u8 id, const Rect& r) {
+        if (id >= MaxEntries) return false;
+        if (r.width == 0 || r.height == 0) return true;  // Overlaps nothing
+
+        u8 cx0 = cell_x(r.x);
+        u8 cx1 = cell_x(static_cast<i16>(r.right() - 1));
+        u8 cy0 = cell_y(r.y);
+        u8 cy1 = cell_y(static_cast<i16>(r.bottom() - 1));
+        u16 needed = static_cast<u16>((cx1 - cx0 + 1) * (cy1 - cy0 + 1));
+        if (entry_count + needed > MaxEntries) return false;
+
+        rect[id] = r;
+        for (u8 cy = cy0; cy <= cy1; cy++) {
+            for (u8 cx = cx0; cx <= cx1; cx++) {
+                u16 cell = static_cast<u16>(cy * Cols + cx);
+                entry_id[entry_count] = id;
+                entry_next[entry_count] = head[cell];
+                head[cell] = entry_count++;
+            }
+        }
+        stats.entries = static_cast<u16>(stats.entries + needed);
+        return true;
+    }
+
+    // Ids of objects overlapping area, each once
+    // Returns the number found (at most max_out are written)
+    u8 query(const Rect& area, u8* out, u8 max_out) {
+        if (area.width == 0 || area.height == 0) return 0;
+        next_stamp();
+
+        u8 found = 0;
+        u8 cx0 = cell_x(area.x);
+        u8 cx1 = cell_x(static_cast<i16>(area.right() - 1));
+        u8 cy0 = cell_y(area.y);
+        u8 cy1 = cell_y(static_cast<i16>(area.bottom() - 1));
+        for (u8 cy = cy0; cy <= cy1; cy++) {
+            for (u8 cx = cx0; cx <= cx1; cx++) {
+                for (u8 e = head[cy * Cols + cx]; e != NO_ENTRY; e = entry_next[e]) {
+                    u8 id = entry_id[e];
+                    if (seen[id] == stamp) continue;
+                    seen[id] = stamp;
+                    stats.rect_tests++;
+                    if (rect[id].overlaps(area)) {
+                        if (found < max_out) out[found] = id;
+                        found++;
+                    }
+                }
+            }
+        }
+        return found;
+    }
+
+    // Call fn(a, b) once for every pair of inserted objects that overlap
+    // A pair sharing several cells is reported only from the cell holding
+    // the top-left corner of their intersection. Returns the pair count.
+    template<typename Fn>
+    u16 for_each_pair(Fn fn) {
+        u16 pairs = 0;
+        for (u16 cell = 0; cell < CELLS; cell++) {
+            for (u8 ea = head[cell]; ea != NO_ENTRY; ea = entry_next[ea]) {
+                u8 a = entry_id[ea];
+                for (u8 eb = entry_next[ea]; eb != NO_ENTRY; eb = entry_next[eb]) {
+                    u8 b = entry_id[eb];
+                    stats.rect_tests++;
+                    if (!rect[a].overlaps(rect[b])) continue;
+
+                    i16 ix = rect[a].x > rect[b].x ? rect[a].x : rect[b].x;
+                    i16 iy = rect[a].y > rect[b].y ? rect[a].y : rect[b].y;
+                    if (static_cast<u16>(cell_y(iy) * Cols + cell_x(ix)) != cell) continue;
+
+                    fn(a, b);
+                    pairs++;
+                }
+            }
+        }
+        stats.pairs = static_cast<u16>(stats.pairs + pairs);
+        return pairs;
+    }
+
+private:
+    u8 cell_x(i16 x) const { return clamp_cell(static_cast<i16>(x - origin_x), Cols); }
+    u8 cell_y(i16 y) const { return clamp_cell(static_cast<i16>(y - origin_y), Rows); }
+
+    static u8 clamp_cell(i16 offset, u8 count) {
+        if (offset < 0) return 0;
+        i16 c = static_cast<i16>(offset >> CellShift);
+        return c >= count ? static_cast<u8>(count - 1) : static_cast<u8>(c);
+    }
+
+    void next_stamp() {
+        if (++stamp == 0) {
+            // Wrapped: old stamps could match again
+            for (u8 i = 0; i < MaxEntries; i++) seen[i] = 0;
+            stamp = 1;
+        }
+    }
+};
+
+// ============================================================================
+// Tile Map Collision
+// ============================================================================
+
+constexpr u8 TILE_SHIFT = 3;  // 8x8 pixel tiles
+
+// Bit-packed collision layer: bit (x & 7) of byte y * stride + (x >> 3) is set
+// for solid tile (x, y); stride = (width + 7) / 8. Tiles outside the map
+// count as solid, so objects cannot leave it.
+struct TileMap {
+    const u8* bits;
+    u16 width;   // Tiles
+    u16 height;  // Tiles
+
+    u16 stride() const { return static_cast<u16>((width + 7) >> 3); }
+
+    bool solid(i16 tx, i16 ty) const {
+        if (tx < 0 || ty < 0 || static_cast<u16>(tx) >= width || static_cast<u16>(ty) >= height) {
+            return true;
+        }
+        u8 byte = bits[static_cast<u32>(ty) * stride() + (static_cast<u16>(tx) >> 3)];
+        return (byte >> (tx & 7)) & 1;
+    }
+
+    // Whether any tile under r (pixels) is solid
+    bool overlaps(const Rect& r) const {
+        if (r.width == 0 || r.height == 0) return false;
+        i16 tx0 = static_cast<i16>(r.x >> TILE_SHIFT);
+        i16 tx1 = static_cast<i16>((r.right() - 1) >> TILE_SHIFT);
+        i16 ty0 = static_cast<i16>(r.y >> TILE_SHIFT);
+        i16 ty1 = static_cast<i16>((r.bottom() - 1) >> TILE_SHIFT);
+        for (i16 ty = ty0; ty <= ty1; ty++) {
+            for (i16 tx = tx0; tx <= tx1; tx++) {
+                if (solid(tx, ty)) return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace snes::collision
@@ -6,6 +6,7 @@
 #include "types.hpp"
 #include "hal.hpp"
 #include "registers.hpp"
+#include "vblank.hpp"
 
 namespace snes::dma {
 
@@ -57,8 +58,7 @@ inline void set_dest(u8 dest) {
 template<u8 Channel>
 inline void set_source(u32 addr) {
     static_assert(Channel < 8, "DMA channel must be 0-7");
-    hal::write8(reg::DMA<Channel>::SRCL::address, static_cast<u8>(addr & 0xFF));
-    hal::write8(reg::DMA<Channel>::SRCM::address, static_cast<u8>((addr >> 8) & 0xFF));
+    reg::DMA<Channel>::SRC::write(static_cast<u16>(addr & 0xFFFF));
     hal::write8(reg::DMA<Channel>::SRCH::address, static_cast<u8>((addr >> 16) & 0xFF));
 }
 
@@ -66,8 +66,7 @@ inline void set_source(u32 addr) {
 template<u8 Channel>
 inline void set_size(u16 size) {
     static_assert(Channel < 8, "DMA channel must be 0-7");
-    hal::write8(reg::DMA<Channel>::SIZEL::address, static_cast<u8>(size & 0xFF));
-    hal::write8(reg::DMA<Channel>::SIZEH::address, static_cast<u8>(size >> 8));
+    reg::DMA<Channel>::SIZE::write(size);
 }
 
 // Start DMA transfer on specified channels (bitmask)
@@ -75,6 +74,148 @@ inline void start(u8 channel_mask) {
     hal::write8(reg::MDMAEN::address, channel_mask);
 }
 
+// ============================================================================
+// Runtime Channel Access
+// ============================================================================
+
+// Same registers as above, for channels only known at runtime
+// (e.g. handed out by the channel allocator)
+
+// Base address of a channel's register block ($43n0)
+inline u32 channel_base(u8 channel) {
+    return 0x4300 + (static_cast<u32>(channel & 0x07) << 4);
+}
+
+inline void set_control(u8 channel, u8 mode_flags) {
+    hal::write8(channel_base(channel) + 0, mode_flags);
+}
+
+inline void set_dest(u8 channel, u8 dest) {
+    hal::write8(channel_base(channel) + 1, dest);
+}
+
+inline void set_source(u8 channel, u32 addr) {
+    u32 base = channel_base(channel);
+    hal::write16(base + 2, static_cast<u16>(addr & 0xFFFF));
+    hal::write8(base + 4, static_cast<u8>((addr >> 16) & 0xFF));
+}
+
+inline void set_size(u8 channel, u16 size) {
+    hal::write16(channel_base(channel) + 5, size);
+}
+
+// ============================================================================
+// Channel Allocation
+// ============================================================================
+
+// HDMA and general-purpose DMA (GPDMA) share the same eight channels. A GPDMA
+// transfer on a channel that HDMA is using corrupts the raster effect, so
+// HDMA effects claim channels from the top (7 downward) and GPDMA uses the
+// rest, starting at 0. The SDK's GPDMA helpers default to channel 0, so
+// HDMA can never have it: effects get channels 1-7.
+
+// Returned when no channel is available
+constexpr u8 NO_CHANNEL = 0xFF;
+
+// Always free for GPDMA; neither ChannelLayout nor the allocator gives it to HDMA
+constexpr u8 GPDMA_CHANNEL = 0;
+
+// Channel bitmask for a single channel
+constexpr u8 channel_bit(u8 channel) {
+    return static_cast<u8>(1 << (channel & 0x07));
+}
+
+// Index of the n-th set bit of mask (lowest first), or NO_CHANNEL
+constexpr u8 nth_channel(u8 mask, u8 n) {
+    for (u8 ch = 0; ch < 8; ch++) {
+        if (mask & channel_bit(ch)) {
+            if (n == 0) return ch;
+            n--;
+        }
+    }
+    return NO_CHANNEL;
+}
+
+// Compile-time channel layout
+// HdmaMask: channels reserved for HDMA effects
+//
+//   using Channels = dma::ChannelLayout<0xC0>;           // HDMA on 6 and 7
+//   dma::hdma_setup_direct<Channels::hdma<0>>(...);      // channel 6
+//   dma::transfer_to_vram<Channels::gpdma<0>>(...);      // channel 0
+template<u8 HdmaMask>
+struct ChannelLayout {
+    static constexpr u8 hdma_mask = HdmaMask;
+    static constexpr u8 gpdma_mask = static_cast<u8>(~HdmaMask);
+
+    static_assert((HdmaMask & (1 << GPDMA_CHANNEL)) == 0, "Channel 0 is reserved for GPDMA");
+
+    // N-th HDMA channel (lowest first)
+    template<u8 N>
+    static constexpr u8 hdma = nth_channel(hdma_mask, N);
+
+    // N-th GPDMA channel (lowest first)
+    template<u8 N>
+    static constexpr u8 gpdma = nth_channel(gpdma_mask, N);
+
+    // True if Channel may be used for GPDMA
+    template<u8 Channel>
+    static constexpr bool is_gpdma = (gpdma_mask & channel_bit(Channel)) != 0;
+};
+
+// Runtime channel allocator
+// Plain data with no constructor: call reset() before first use
+struct ChannelAllocator {
+    u8 hdma_mask;  // Channels currently claimed by HDMA effects
+
+    void reset() { hdma_mask = 0; }
+
+    // Channels available for GPDMA
+    u8 gpdma_mask() const { return static_cast<u8>(~hdma_mask); }
+
+    bool is_hdma(u8 channel) const {
+        return (hdma_mask & channel_bit(channel)) != 0;
+    }
+
+    // Claim the highest free channel for HDMA
+    // Returns the channel, or NO_CHANNEL once 1-7 are all claimed
+    // (GPDMA_CHANNEL is never handed out)
+    u8 claim_hdma() {
+        u8 free_mask = gpdma_mask();
+        for (u8 ch = 8; --ch > GPDMA_CHANNEL;) {
+            if (free_mask & channel_bit(ch)) {
+                hdma_mask |= channel_bit(ch);
+                return ch;
+            }
+        }
+        return NO_CHANNEL;
+    }
+
+    // Claim a specific channel for HDMA
+    // Returns false if it is already claimed or is GPDMA_CHANNEL
+    bool claim_hdma(u8 channel) {
+        if (channel >= 8 || channel == GPDMA_CHANNEL || is_hdma(channel)) return false;
+        hdma_mask |= channel_bit(channel);
+        return true;
+    }
+
+    // Return an HDMA channel to the GPDMA pool
+    void release_hdma(u8 channel) {
+        hdma_mask &= static_cast<u8>(~channel_bit(channel));
+    }
+
+    // N-th free GPDMA channel (lowest first), or NO_CHANNEL
+    u8 gpdma_channel(u8 n = 0) const {
+        return nth_channel(gpdma_mask(), n);
+    }
+};
+
+#ifdef SNES_TESTING
+// For unit tests, this is defined in src/dma.cpp
+extern ChannelAllocator g_channels;
+#else
+inline ChannelAllocator g_channels;
+#endif
+
 // ============================================================================
 // High-Level Transfer Functions
 // ============================================================================
@@ -90,8 +231,7 @@ inline void transfer_to_vram(const void* src, u16 vram_addr, u16 size) {
 
     // Set VRAM address
     hal::write8(reg::VMAIN::address, 0x80);  // Increment on high byte write
-    hal::write8(reg::VMADDL::address, static_cast<u8>(vram_addr & 0xFF));
-    hal::write8(reg::VMADDH::address, static_cast<u8>(vram_addr >> 8));
+    reg::VMADD::write(vram_addr);
 
     // Configure DMA
     set_control<Channel>(mode::WORD_TO_TWO | addr::INCREMENT | dir::TO_PPU);
@@ -103,6 +243,38 @@ inline void transfer_to_vram(const void* src, u16 vram_addr, u16 size) {
     start(static_cast<u8>(1 << Channel));
 }
 
+// Runtime-channel variant, for channels from g_channels.gpdma_channel()
+inline void transfer_to_vram(u8 channel, const void* src, u16 vram_addr, u16 size) {
+    hal::write8(reg::VMAIN::address, 0x80);
+    reg::VMADD::write(vram_addr);
+
+    set_control(channel, mode::WORD_TO_TWO | addr::INCREMENT | dir::TO_PPU);
+    set_dest(channel, 0x18);  // VMDATAL
+    set_source(channel, reinterpret_cast<u32>(src));
+    set_size(channel, size);
+
+    start(channel_bit(channel));
+}
+
+// Transfer one tilemap column to VRAM (VRAM address steps by 32 words)
+// src: Consecutive tilemap entries, top to bottom
+// vram_addr: Word address of the column's first entry
+// size: Number of bytes (2 per entry, at most 64 for a 32-row map)
+template<u8 Channel = 0>
+inline void transfer_to_vram_column(const void* src, u16 vram_addr, u16 size) {
+    static_assert(Channel < 8, "DMA channel must be 0-7");
+
+    hal::write8(reg::VMAIN::address, 0x81);  // Increment by 32 on high byte write
+    reg::VMADD::write(vram_addr);
+
+    set_control<Channel>(mode::WORD_TO_TWO | addr::INCREMENT | dir::TO_PPU);
+    set_dest<Channel>(0x18);  // VMDATAL
+    set_source<Channel>(reinterpret_cast<u32>(src));
+    set_size<Channel>(size);
+
+    start(static_cast<u8>(1 << Channel));
+}
+
 // Transfer data to CGRAM (palette)
 // channel: DMA channel to use (0-7)
 // src: Source address (array of BGR555 colors)
@@ -129,13 +301,13 @@ inline void transfer_to_cgram(const void* src, u8 start_color, u16 count) {
 // channel: DMA channel to use (0-7)
 // src: Source address (OAM shadow buffer)
 // size: Number of bytes (max 544)
+// oam_addr: Destination word address (0-255 low table, 256-271 high table)
 template<u8 Channel = 0>
-inline void transfer_to_oam(const void* src, u16 size = 544) {
+inline void transfer_to_oam(const void* src, u16 size = 544, u16 oam_addr = 0) {
     static_assert(Channel < 8, "DMA channel must be 0-7");
 
-    // Set OAM address to 0
-    hal::write8(reg::OAMADDL::address, 0);
-    hal::write8(reg::OAMADDH::address, 0);
+    // Set OAM address
+    reg::OAMADD::write(oam_addr);
 
     // Configure DMA
     set_control<Channel>(mode::BYTE_TO_ONE | addr::INCREMENT | dir::TO_PPU);
@@ -166,6 +338,11 @@ inline void hdma_disable() {
     hal::write8(reg::HDMAEN::address, 0);
 }
 
+// Enable exactly the channels claimed through g_channels
+inline void hdma_enable_claimed() {
+    hal::write8(reg::HDMAEN::address, g_channels.hdma_mask);
+}
+
 // Set up HDMA channel for direct mode
 // channel: HDMA channel (0-7)
 // dest: B-bus register ($21xx low byte)
@@ -192,28 +369,60 @@ inline void hdma_setup_indirect(u8 dest, const void* table, u8 mode_flags = mode
     set_source<Channel>(reinterpret_cast<u32>(table));
 }
 
+// Runtime-channel variants, for channels from g_channels.claim_hdma()
+inline void hdma_setup_direct(u8 channel, u8 dest, const void* table,
+                              u8 mode_flags = mode::BYTE_TO_ONE) {
+    set_control(channel, mode_flags | addr::INCREMENT);
+    set_dest(channel, dest);
+    set_source(channel, reinterpret_cast<u32>(table));
+}
+
+inline void hdma_setup_indirect(u8 channel, u8 dest, const void* table,
+                                u8 mode_flags = mode::BYTE_TO_ONE) {
+    set_control(channel, mode_flags | addr::INCREMENT | 0x40);
+    set_dest(channel, dest);
+    set_source(channel, reinterpret_cast<u32>(table));
+}
+
 // ============================================================================
 // Convenience Functions
 // ============================================================================
 
 // Fill VRAM with a single word value
-// Note: This requires a small buffer containing the value to repeat
+// value_ptr: the word to repeat, in CPU memory
+// A fixed-source word DMA reads the same byte for VMDATAL and VMDATAH, so
+// unless both bytes of the value match, the low and high bytes go out as
+// two single-register passes (two MDMAEN writes)
+inline void fill_vram(u8 channel, u16 vram_addr, const u16* value_ptr, u16 word_count) {
+    const u8* bytes = reinterpret_cast<const u8*>(value_ptr);
+
+    if (bytes[0] == bytes[1]) {
+        hal::write8(reg::VMAIN::address, 0x80);
+        reg::VMADD::write(vram_addr);
+        set_control(channel, mode::WORD_TO_TWO | addr::FIXED | dir::TO_PPU);
+        set_dest(channel, 0x18);  // VMDATAL
+        set_source(channel, reinterpret_cast<u32>(bytes));
+        set_size(channel, static_cast<u16>(word_count * 2));
+        start(channel_bit(channel));
+        return;
+    }
+
+    const u8 pass_vmain[2] = {0x00, 0x80};  // Increment after VMDATAL / VMDATAH
+    for (u8 half = 0; half < 2; half++) {
+        hal::write8(reg::VMAIN::address, pass_vmain[half]);
+        reg::VMADD::write(vram_addr);
+        set_control(channel, mode::BYTE_TO_ONE | addr::FIXED | dir::TO_PPU);
+        set_dest(channel, static_cast<u8>(0x18 + half));  // VMDATAL / VMDATAH
+        set_source(channel, reinterpret_cast<u32>(bytes + half));
+        set_size(channel, word_count);
+        start(channel_bit(channel));
+    }
+}
+
 template<u8 Channel = 0>
 inline void fill_vram(u16 vram_addr, const u16* value_ptr, u16 word_count) {
     static_assert(Channel < 8, "DMA channel must be 0-7");
-
-    // Set VRAM address
-    hal::write8(reg::VMAIN::address, 0x80);
-    hal::write8(reg::VMADDL::address, static_cast<u8>(vram_addr & 0xFF));
-    hal::write8(reg::VMADDH::address, static_cast<u8>(vram_addr >> 8));
-
-    // Use fixed source address mode
-    set_control<Channel>(mode::WORD_TO_TWO | addr::FIXED | dir::TO_PPU);
-    set_dest<Channel>(0x18);  // VMDATAL
-    set_source<Channel>(reinterpret_cast<u32>(value_ptr));
-    set_size<Channel>(static_cast<u16>(word_count * 2));
-
-    start(static_cast<u8>(1 << Channel));
+    fill_vram(Channel, vram_addr, value_ptr, word_count);
 }
 
 // Upload tiles to VRAM (alias for transfer_to_vram)
@@ -234,4 +443,400 @@ inline void upload_palette(const void* palette, u8 start_color, u8 color_count)
     transfer_to_cgram<Channel>(palette, start_color, static_cast<u16>(color_count * 2));
 }
 
+// ============================================================================
+// VBlank Transfer Queue
+// ============================================================================
+
+// Game code can queue transfers at any point in the frame; the NMI handler
+// drains the queue in one burst during VBlank (see install_queue()).
+// Each flush stops once the per-frame byte budget is spent. A transfer that
+// does not fit is split at an even byte boundary and its remainder stays at
+// the head of the queue for the next frame, so large uploads never overrun
+// VBlank and tear.
+
+// Transfer destinations
+namespace target {
+    constexpr u8 VRAM      = 0;  // VRAM, dest = word address
+    constexpr u8 VRAM_FILL = 1;  // VRAM from a fixed source word, dest = word address
+    constexpr u8 CGRAM     = 2;  // CGRAM, dest = color index
+    constexpr u8 OAM       = 3;  // OAM, dest = word address
+}
+
+// Maximum number of pending transfers (power of two)
+constexpr u8 QUEUE_CAPACITY = 16;
+
+// DMA bytes per NTSC VBlank for all NMI transfers together: roughly 6KB
+// fits, the rest is left for NMI overhead. The OAM upload, this queue and
+// text::install_flush() share it, and their defaults add up to it
+constexpr u16 VBLANK_DMA_BUDGET = 5632;
+
+// Full shadow OAM upload (ppu::sprites_upload(true))
+constexpr u16 OAM_UPLOAD_BYTES = 544;
+
+// Default per-frame budget of the queue in bytes
+constexpr u16 DEFAULT_FRAME_BUDGET = 3072;
+
+// Queued transfer
+struct Transfer {
+    const u8* src;  // A-bus source (not advanced for VRAM_FILL)
+    u16 dest;       // Destination address (meaning depends on target)
+    u16 size;       // Bytes still to send
+    u8 target;      // target:: constant
+};
+
+// Fixed-capacity FIFO of deferred transfers
+// Plain data with no constructor: call reset() before first use
+//
+// push() runs in main code and flush() in the NMI handler, so the two sides
+// never write the same field: the producer only advances tail, the consumer
+// only advances head, and the pending count is derived from both. Indices
+// run freely and wrap at 256, which QUEUE_CAPACITY divides.
+// A slot is filled before tail moves past it, so flush() never sees a
+// half-written transfer.
+struct TransferQueue {
+    Transfer entries[QUEUE_CAPACITY];
+    volatile u8 head;  // Next transfer to send (written by flush() only)
+    volatile u8 tail;  // Next free slot (written by push() only)
+    u16 budget;        // Bytes sent per flush()
+
+    // Drop all pending transfers and set the per-frame budget
+    // Not safe against a concurrent flush(): call with NMI off or the hook removed
+    void reset(u16 frame_budget = DEFAULT_FRAME_BUDGET) {
+        head = 0;
+        tail = 0;
+        budget = frame_budget;
+    }
+
+    // Number of pending transfers
+    u8 count() const { return static_cast<u8>(tail - head); }
+
+    bool empty() const { return head == tail; }
+    bool full() const { return count() == QUEUE_CAPACITY; }
+
+    // Transfer at the head of the queue (only meaningful when not empty)
+    Transfer& front() { return entries[head & (QUEUE_CAPACITY - 1)]; }
+
+    // Total bytes still waiting to be sent
+    u16 pending_bytes() const {
+        u16 total = 0;
+        u8 end = tail;
+        for (u8 i = head; i != end; i++) {
+            total = static_cast<u16>(total + entries[i & (QUEUE_CAPACITY - 1)].size);
+        }
+        return total;
+    }
+
+    // Append a transfer
+    // Returns false if the queue is full or size is 0
+    bool push(u8 tgt, const void* src, u16 dest, u16 size) {
+        if (full() || size == 0) return false;
+        u8 slot = tail;
+
+        // Fill through a volatile view so the stores cannot sink below the
+        // tail update that publishes them
+        volatile Transfer& t = entries[slot & (QUEUE_CAPACITY - 1)];
+        t.src = static_cast<const u8*>(src);
+        t.dest = dest;
+        t.size = size;
+        t.target = tgt;
+        tail = static_cast<u8>(slot + 1);
+        return true;
+    }
+
+    // Send pending transfers until the queue is empty or the budget is spent
+    // Must be called during VBlank or forced blank
+    // Returns the number of bytes sent
+    template<u8 Channel = 0>
+    u16 flush() {
+        static_assert(Channel < 8, "DMA channel must be 0-7");
+
+        u16 remaining = budget;
+        u16 sent = 0;
+        u8 next = head;
+        u8 end = tail;
+
+        while (next != end) {
+            Transfer& t = entries[next & (QUEUE_CAPACITY - 1)];
+
+            // Split at an even boundary so word-addressed targets stay aligned
+            u16 chunk = t.size;
+            if (chunk > remaining) chunk = static_cast<u16>(remaining & 0xFFFE);
+            if (chunk == 0) break;
+
+            switch (t.target) {
+                case target::VRAM:
+                    transfer_to_vram<Channel>(t.src, t.dest, chunk);
+                    break;
+                case target::VRAM_FILL:
+                    fill_vram<Channel>(t.dest, reinterpret_cast<const u16*>(t.src),
+                                       static_cast<u16>(chunk >> 1));
+                    break;
+                case target::CGRAM:
+                    transfer_to_cgram<Channel>(t.src, static_cast<u8>(t.dest), chunk);
+                    break;
+                case target::OAM:
+                    transfer_to_oam<Channel>(t.src, chunk, t.dest);
+                    break;
+            }
+
+            remaining = static_cast<u16>(remaining - chunk);
+            sent = static_cast<u16>(sent + chunk);
+
+            if (chunk == t.size) {
+                next++;
+            } else {
+                // Spill the remainder to the next frame
+                // All targets advance one address unit per 2 bytes
+                t.size = static_cast<u16>(t.size - chunk);
+                t.dest = static_cast<u16>(t.dest + (chunk >> 1));
+                if (t.target != target::VRAM_FILL) t.src += chunk;
+                break;
+            }
+        }
+
+        head = next;
+        return sent;
+    }
+};
+
+#ifdef SNES_TESTING
+// For unit tests, this is defined in src/dma.cpp
+extern TransferQueue g_queue;
+#else
+inline TransferQueue g_queue;
+#endif
+
+// Queue a VRAM upload (see transfer_to_vram)
+// Returns false if the queue is full
+inline bool queue_vram(const void* src, u16 vram_addr, u16 size) {
+    return g_queue.push(target::VRAM, src, vram_addr, size);
+}
+
+// Queue a VRAM fill with a repeated word (see fill_vram)
+// value_ptr must stay valid until the fill has been flushed
+inline bool queue_fill_vram(u16 vram_addr, const u16* value_ptr, u16 word_count) {
+    return g_queue.push(target::VRAM_FILL, value_ptr, vram_addr,
+                        static_cast<u16>(word_count * 2));
+}
+
+// Queue a CGRAM upload (see transfer_to_cgram)
+inline bool queue_cgram(const void* src, u8 start_color, u16 count) {
+    return g_queue.push(target::CGRAM, src, start_color, count);
+}
+
+// Queue an OAM upload (see transfer_to_oam)
+inline bool queue_oam(const void* src, u16 size = 544, u16 oam_addr = 0) {
+    return g_queue.push(target::OAM, src, oam_addr, size);
+}
+
+// Flush the global queue (for custom NMI handlers or forced blank loads)
+inline u16 flush_queue() {
+    return g_queue.flush();
+}
+
+namespace detail {
+inline void flush_queue_nmi() {
+    g_queue.flush();
+}
+} // namespace detail
+
+// Reset the global queue and have the NMI handler flush it every frame
+// Call during forced blank, then enable NMI with vblank::enable()
+// Returns false if no VBlank hook slot is free
+//
+// While installed, the NMI handler owns GPDMA_CHANNEL and the VMAIN,
+// VMADD, CGADD and OAMADD ports. It rewrites them without restoring
+// (VMADD cannot be read back), so an NMI in the middle of a main-code
+// transfer corrupts it. With NMI enabled, main code must not start DMA
+// or write those ports itself: no transfer_to_*, Batch::kick,
+// ppu::sprites_upload or Scroller::commit. Queue the data, or do the
+// transfer from another VBlank hook (hooks run one after another).
+inline bool install_queue(u16 frame_budget = DEFAULT_FRAME_BUDGET) {
+    g_queue.reset(frame_budget);
+    return vblank::add_hook(detail::flush_queue_nmi);
+}
+
+// Stop flushing the global queue from the NMI handler
+inline void uninstall_queue() {
+    vblank::remove_hook(detail::flush_queue_nmi);
+}
+
+// ============================================================================
+// Batched Transfers
+// ============================================================================
+
+// Programs up to eight channels and starts them all with one MDMAEN write.
+// The hardware runs enabled channels lowest first, and channels are taken
+// lowest first, so transfers run in the order they were added.
+//
+// add() only records the transfer; kick() programs the channels and the
+// PPU port addresses right before MDMAEN, so building a batch during
+// active display touches no registers.
+//
+// VMADD, CGADD and OAMADD are shared by every channel, so a batch can
+// address each PPU port once. A second transfer to the same port is only
+// accepted if it continues exactly where the previous one ended.
+//
+// A VRAM fill whose two bytes differ needs two passes with different VMAIN
+// settings (see fill_vram()), so it splits the kick: transfers before it
+// start together, then the two fill passes, then the rest.
+//
+//   dma::Batch b;
+//   b.begin();
+//   b.add_vram(tiles, 0x0000, sizeof(tiles));
+//   b.add_vram(tilemap, 0x0000 + sizeof(tiles) / 2, sizeof(tilemap));
+//   b.add_cgram(palette, 0, 32);
+//   b.add_oam(oam_shadow);
+//   u16 bytes = b.kick();
+
+// Plain data with no constructor: call begin() before first use
+struct Batch {
+    Transfer entries[8]; // Recorded transfers, in add() order
+    u8 channels[8];      // Channel of each entry
+    u8 length;           // Entries recorded
+    u8 addressing;       // Bit per entry that sets its port's address
+    u8 free_mask;        // Channels still available to this batch
+    u8 mask;             // Channels used so far
+    u8 ports;            // Ports addressed so far (bit per target::, fill uses VRAM)
+    u8 open_ports;       // Ports where a continuation may be appended
+    u16 port_next[4];    // Address the next continuation must start at
+    u16 total;           // Bytes recorded so far
+
+    // Start an empty batch
+    // channel_mask: channels it may use (default: all GPDMA channels)
+    void begin(u8 channel_mask = g_channels.gpdma_mask()) {
+        length = 0;
+        addressing = 0;
+        free_mask = channel_mask;
+        mask = 0;
+        ports = 0;
+        open_ports = 0;
+        total = 0;
+    }
+
+    bool empty() const { return length == 0; }
+
+    // Record a transfer on the next free channel
+    // Returns false if no channel is left, size is 0, or the port was
+    // already addressed at a different location in this batch
+    bool add(u8 tgt, const void* src, u16 dest, u16 size) {
+        u8 ch = nth_channel(free_mask, 0);
+        if (ch == NO_CHANNEL || size == 0 || tgt > target::OAM) return false;
+
+        u8 port = (tgt == target::VRAM_FILL) ? target::VRAM : tgt;
+        u8 port_bit = static_cast<u8>(1 << port);
+
+        if (ports & port_bit) {
+            if (!(open_ports & port_bit) || port_next[port] != dest) return false;
+        } else {
+            addressing |= static_cast<u8>(1 << length);
+            ports |= port_bit;
+        }
+
+        Transfer& t = entries[length];
+        t.src = static_cast<const u8*>(src);
+        t.dest = dest;
+        t.size = size;
+        t.target = tgt;
+        channels[length] = ch;
+        length++;
+
+        // All ports advance one address unit per 2 bytes; an odd size leaves
+        // the port mid-word, so nothing can follow it
+        if (size & 1) {
+            open_ports &= static_cast<u8>(~port_bit);
+        } else {
+            open_ports |= port_bit;
+            port_next[port] = static_cast<u16>(dest + (size >> 1));
+        }
+
+        free_mask &= static_cast<u8>(~channel_bit(ch));
+        mask |= channel_bit(ch);
+        total = static_cast<u16>(total + size);
+        return true;
+    }
+
+    bool add_vram(const void* src, u16 vram_addr, u16 size) {
+        return add(target::VRAM, src, vram_addr, size);
+    }
+
+    // value_ptr must stay valid until kick()
+    bool add_fill_vram(u16 vram_addr, const u16* value_ptr, u16 word_count) {
+        return add(target::VRAM_FILL, value_ptr, vram_addr, static_cast<u16>(word_count * 2));
+    }
+
+    bool add_cgram(const void* src, u8 start_color, u16 count) {
+        return add(target::CGRAM, src, start_color, count);
+    }
+
+    bool add_oam(const void* src, u16 size = 544, u16 oam_addr = 0) {
+        return add(target::OAM, src, oam_addr, size);
+    }
+
+    // Program every recorded transfer and start them with a single MDMAEN
+    // write (more if a two-pass VRAM fill splits the batch)
+    // Must be called during VBlank or forced blank
+    // Returns the number of bytes transferred
+    u16 kick() {
+        u8 group = 0;  // Channels programmed but not yet started
+
+        for (u8 i = 0; i < length; i++) {
+            const Transfer& t = entries[i];
+            u8 ch = channels[i];
+
+            if (t.target == target::VRAM_FILL && t.src[0] != t.src[1]) {
+                if (group != 0) start(group);
+                group = 0;
+                fill_vram(ch, t.dest, reinterpret_cast<const u16*>(t.src),
+                          static_cast<u16>(t.size >> 1));
+                continue;
+            }
+
+            if (addressing & (1 << i)) set_port_address(t.target, t.dest);
+
+            switch (t.target) {
+                case target::VRAM:
+                    set_control(ch, mode::WORD_TO_TWO | addr::INCREMENT | dir::TO_PPU);
+                    set_dest(ch, 0x18);  // VMDATAL
+                    break;
+                case target::VRAM_FILL:
+                    set_control(ch, mode::WORD_TO_TWO | addr::FIXED | dir::TO_PPU);
+                    set_dest(ch, 0x18);  // VMDATAL
+                    break;
+                case target::CGRAM:
+                    set_control(ch, mode::BYTE_TO_ONE | addr::INCREMENT | dir::TO_PPU);
+                    set_dest(ch, 0x22);  // CGDATA
+                    break;
+                case target::OAM:
+                    set_control(ch, mode::BYTE_TO_ONE | addr::INCREMENT | dir::TO_PPU);
+                    set_dest(ch, 0x04);  // OAMDATA
+                    break;
+            }
+            set_source(ch, reinterpret_cast<u32>(t.src));
+            set_size(ch, t.size);
+            group |= channel_bit(ch);
+        }
+
+        if (group != 0) start(group);
+        return total;
+    }
+
+private:
+    static void set_port_address(u8 tgt, u16 dest) {
+        switch (tgt) {
+            case target::VRAM:
+            case target::VRAM_FILL:
+                hal::write8(reg::VMAIN::address, 0x80);
+                reg::VMADD::write(dest);
+                break;
+            case target::CGRAM:
+                hal::write8(reg::CGADD::address, static_cast<u8>(dest));
+                break;
+            case target::OAM:
+                reg::OAMADD::write(dest);
+                break;
+        }
+    }
+};
+
 } // namespace snes::dma
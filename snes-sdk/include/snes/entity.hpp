@@ -0,0 +1,183 @@
+#pragma once
+
+// SNES Entity API - Structure-of-arrays pool for game objects
+//
+// Each field lives in its own array indexed by an 8-bit entity id, so the
+// per-frame passes are simple indexed loads and stores (one index register,
+// no pointer arithmetic or struct strides). Live ids are also kept in a
+// dense list, so the passes touch only live entities.
+//
+// Positions and velocities are 12.4 fixed point (Coord): -2048 to 2047
+// pixels with 1/16 pixel steps.
+//
+//   entity::Pool<96> bullets;            // plain data: reset() first
+//   bullets.reset();
+//   u8 id = bullets.spawn(Coord::from_int(x), Coord::from_int(y), vx, vy, KIND_BULLET);
+//   bullets.tile[id] = BULLET_TILE;
+//   loop:
+//       bullets.integrate();
+//       bullets.cull(arena);              // kill entities that left the arena
+//       sprites.begin_frame();
+//       bullets.draw(sprites, cam_x, cam_y);
+//       sprites.end_frame();
+
+#include "types.hpp"
+#include "ppu.hpp"
+
+namespace snes::entity {
+
+// 12.4 fixed point world coordinate
+using Coord = Fixed<12, 4>;
+
+// Returned by spawn() when the pool is full
+constexpr u8 NO_ENTITY = 0xFF;
+
+// state value of a free slot; any other value is game-defined
+constexpr u8 STATE_FREE = 0;
+
+// flags bits
+namespace flag {
+    constexpr u8 LARGE  = 0x01;  // Large sprite size (see OBSEL)
+    constexpr u8 HIDDEN = 0x02;  // Skipped by draw()
+}
+
+// Sprites drawn by draw() may start this far left of or above the screen
+constexpr i16 DRAW_MARGIN = 64;
+
+// Capacity: at most 254 entities (ids 0 to Capacity - 1)
+// Plain data with no constructor: call reset() before first use
+template<u8 Capacity>
+struct Pool {
+    static_assert(Capacity >= 1 && Capacity < NO_ENTITY, "Entity pool capacity must be 1-254");
+
+    // Per-entity fields (raw Coord values)
+    i16 x[Capacity];
+    i16 y[Capacity];
+    i16 vx[Capacity];
+    i16 vy[Capacity];
+    u8 state[Capacity];
+    u8 flags[Capacity];
+    u8 tile[Capacity];  // Tile number (low 8 bits)
+    u8 attr[Capacity];  // OAM attributes: vhoopppc
+
+    // Bookkeeping
+    u8 next_free[Capacity];     // Freelist links
+    u8 active[Capacity];        // Live ids, dense
+    u8 active_index[Capacity];  // Position of each live id in active[]
+    u8 free_head;
+    u8 count;
+
+    // Free every slot
+    void reset() {
+        for (u8 i = 0; i < Capacity; i++) {
+            state[i] = STATE_FREE;
+            next_free[i] = static_cast<u8>(i + 1);
+        }
+        next_free[Capacity - 1] = NO_ENTITY;
+        free_head = 0;
+        count = 0;
+    }
+
+    // Take a slot off the freelist; returns its id, or NO_ENTITY when full
+    // kind must not be STATE_FREE. tile/attr/flags are cleared.
+    u8 spawn(Coord px, Coord py, Coord pvx, Coord pvy, u8 kind) {
+        u8 id = free_head;
+        if (id == NO_ENTITY) return NO_ENTITY;
+        free_head = next_free[id];
+
+        x[id] = px.raw;
+        y[id] = py.raw;
+        vx[id] = pvx.raw;
+        vy[id] = pvy.raw;
+        state[id] = kind;
+        flags[id] = 0;
+        tile[id] = 0;
+        attr[id] = 0;
+
+        active_index[id] = count;
+        active[count++] = id;
+        return id;
+    }
+
+    // Return a live entity to the freelist
+    void kill(u8 id) {
+        if (id >= Capacity || state[id] == STATE_FREE) return;
+        state[id] = STATE_FREE;
+
+        // Move the last live id into the hole
+        u8 pos = active_index[id];
+        u8 last = active[--count];
+        active[pos] = last;
+        active_index[last] = pos;
+
+        next_free[id] = free_head;
+        free_head = id;
+    }
+
+    bool alive(u8 id) const { return id < Capacity && state[id] != STATE_FREE; }
+
+    bool full() const { return free_head == NO_ENTITY; }
+
+    // Apply velocity to every live entity
+    void integrate() {
+        for (u8 i = 0; i < count; i++) {
+            u8 id = active[i];
+            x[id] = static_cast<i16>(x[id] + vx[id]);
+            y[id] = static_cast<i16>(y[id] + vy[id]);
+        }
+    }
+
+    // Kill every entity whose position (in pixels) is outside bounds
+    // Returns the number killed
+    u8 cull(const Rect& bounds) {
+        u8 killed = 0;
+        // Backwards, so swap-removal only moves already-checked ids
+        for (u8 i = count; i-- > 0;) {
+            u8 id = active[i];
+            if (!bounds.contains(static_cast<i16>(x[id] >> 4), static_cast<i16>(y[id] >> 4))) {
+                kill(id);
+                killed++;
+            }
+        }
+        return killed;
+    }
+
+    // Write every visible live entity into the next free sprite slots,
+    // relative to the camera (pixels). Off-screen and HIDDEN entities are
+    // skipped. Stops when the sprite pool runs out; returns sprites written.
+    u8 draw(ppu::SpritePool& sprites, i16 cam_x, i16 cam_y) {
+        u8 drawn = 0;
+        for (u8 i = 0; i < count; i++) {
+            u8 id = active[i];
+            if (flags[id] & flag::HIDDEN) continue;
+
+            i16 sx = static_cast<i16>((x[id] >> 4) - cam_x);
+            i16 sy = static_cast<i16>((y[id] >> 4) - cam_y);
+            if (sx <= -DRAW_MARGIN || sx >= 256 || sy <= -DRAW_MARGIN || sy >= 224) continue;
+
+            u8 slot = sprites.alloc();
+            if (slot == ppu::NO_SPRITE) break;
+
+            ppu::OAMEntry& e = ppu::oam_low[slot];
+            e.x_low = static_cast<u8>(sx & 0xFF);
+            e.y = static_cast<u8>(sy & 0xFF);
+            e.tile = tile[id];
+            e.attr = attr[id];
+            ppu::oam_dirty.mark_low(slot);
+
+            // High table: X bit 8 and size, 2 bits per sprite
+            u8 byte_idx = static_cast<u8>(slot >> 2);
+            u8 shift = static_cast<u8>((slot & 0x03) << 1);
+            u8 bits = static_cast<u8>(((sx & 0x100) ? 0x01 : 0) | ((flags[id] & flag::LARGE) ? 0x02 : 0));
+            u8 high = static_cast<u8>((ppu::oam_high[byte_idx] & ~(0x03 << shift)) | (bits << shift));
+            if (high != ppu::oam_high[byte_idx]) {
+                ppu::oam_high[byte_idx] = high;
+                ppu::oam_dirty.mark_high(byte_idx);
+            }
+            drawn++;
+        }
+        return drawn;
+    }
+};
+
+} // namespace snes::entity
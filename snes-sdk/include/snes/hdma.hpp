@@ -0,0 +1,273 @@
+#pragma once
+
+// SNES HDMA API - Table builder for per-scanline effects
+//
+// An HDMA table is a list of entries ending in a 0x00 byte:
+//   [count] [data x Unit]            hold one value for count lines (1-127)
+//   [0x80 | count] [data x Unit]...  repeat mode: one value per line
+// Unit is the number of bytes the channel's transfer mode writes per line.
+//
+// Table methods are constexpr, so fixed effects can be built at compile time:
+//
+//   constexpr auto kSky = [] {
+//       hdma::Table<1, 64> t{};
+//       t.reset();
+//       hdma::gradient(t, 31, 0, 224, hdma::coldata::BLUE);
+//       return t;
+//   }();
+//   hdma::attach(channel, hdma::target::COLDATA, kSky);
+//
+// Effects that change every frame go in a DoubleBuffer: rebuild back() during
+// active display, present() it, and commit() in VBlank.
+
+#include "types.hpp"
+#include "hal.hpp"
+#include "registers.hpp"
+#include "dma.hpp"
+
+namespace snes::hdma {
+
+// ============================================================================
+// Table
+// ============================================================================
+
+// Longest entry the line count byte can describe
+constexpr u8 MAX_RUN = 127;
+
+// Unit: bytes per line (1, 2 or 4, matching the transfer mode)
+// Capacity: table size in bytes, including the end marker
+// Plain data with no constructor: call reset() before first use
+// (constexpr tables: declare as Table<...> t{} and then reset())
+template<u8 Unit, u16 Capacity>
+struct Table {
+    static_assert(Unit == 1 || Unit == 2 || Unit == 4, "HDMA unit must be 1, 2 or 4 bytes");
+    static_assert(Capacity >= 1 + Unit + 1, "HDMA table too small for one entry");
+
+    static constexpr u8 unit = Unit;
+
+    u8 bytes[Capacity];
+    u16 size;    // Bytes used, not counting the end marker
+    u16 run_at;  // Header of the open repeat run, or Capacity if none
+
+    // Empty table (just the end marker)
+    constexpr void reset() {
+        size = 0;
+        run_at = Capacity;
+        bytes[0] = 0;
+    }
+
+    // Scanlines covered so far
+    constexpr u16 lines() const {
+        u16 total = 0;
+        u16 i = 0;
+        while (i < size) {
+            u8 header = bytes[i];
+            u8 count = static_cast<u8>(header & 0x7F);
+            total = static_cast<u16>(total + count);
+            i = static_cast<u16>(i + 1 + ((header & 0x80) ? count * Unit : Unit));
+        }
+        return total;
+    }
+
+    // Hold value for the next line_count scanlines
+    // Returns false if the table is full (what fit is kept)
+    constexpr bool hold(u16 line_count, u32 value) {
+        run_at = Capacity;
+        while (line_count != 0) {
+            u8 count = line_count > MAX_RUN ? MAX_RUN : static_cast<u8>(line_count);
+            if (size + 1 + Unit + 1 > Capacity) return false;
+            bytes[size++] = count;
+            put(value);
+            line_count = static_cast<u16>(line_count - count);
+        }
+        return true;
+    }
+
+    // Write value on the next scanline only (repeat mode)
+    // Consecutive calls share one entry header
+    // Returns false if the table is full
+    constexpr bool line(u32 value) {
+        if (run_at != Capacity && (bytes[run_at] & 0x7F) < MAX_RUN) {
+            if (size + Unit + 1 > Capacity) return false;
+            bytes[run_at]++;
+        } else {
+            if (size + 1 + Unit + 1 > Capacity) return false;
+            run_at = size;
+            bytes[size++] = 0x81;
+        }
+        put(value);
+        return true;
+    }
+
+    // Open a repeat-mode entry for the next count scanlines (1-MAX_RUN) and
+    // return its data, Unit bytes per line, for the caller to fill in place
+    // (cheaper than count calls to line() for tables rebuilt every frame)
+    // Returns nullptr if the table is full
+    constexpr u8* reserve_lines(u8 count) {
+        if (count == 0 || count > MAX_RUN || size + 1 + count * Unit + 1 > Capacity) return nullptr;
+        run_at = Capacity;
+        bytes[size++] = static_cast<u8>(0x80 | count);
+        u8* data = &bytes[size];
+        size = static_cast<u16>(size + count * Unit);
+        bytes[size] = 0;
+        return data;
+    }
+
+private:
+    // Append one unit (little-endian) and keep the end marker in place
+    constexpr void put(u32 value) {
+        for (u8 i = 0; i < Unit; i++) {
+            bytes[size++] = static_cast<u8>((value >> (i * 8)) & 0xFF);
+        }
+        bytes[size] = 0;
+    }
+};
+
+// ============================================================================
+// Targets
+// ============================================================================
+
+// B-bus register and transfer mode for common effects
+struct Target {
+    u8 dest;  // $21xx low byte
+    u8 mode;  // DMAPn transfer mode
+    u8 unit;  // Bytes per line
+};
+
+namespace target {
+    // Write-twice scroll registers: mode 2 writes both bytes to one register
+    constexpr Target BG1HOFS = {0x0D, 0x02, 2};
+    constexpr Target BG1VOFS = {0x0E, 0x02, 2};
+    constexpr Target BG2HOFS = {0x0F, 0x02, 2};
+    constexpr Target BG2VOFS = {0x10, 0x02, 2};
+    constexpr Target BG3HOFS = {0x11, 0x02, 2};
+    constexpr Target BG3VOFS = {0x12, 0x02, 2};
+
+    // Window 1 left/right (WH0, WH1): mode 1 writes two adjacent registers
+    constexpr Target WINDOW1 = {0x26, 0x01, 2};
+    constexpr Target WINDOW2 = {0x28, 0x01, 2};
+
+    constexpr Target COLDATA = {0x32, 0x00, 1};  // Fixed color
+    constexpr Target INIDISP = {0x00, 0x00, 1};  // Brightness / force blank
+}
+
+// COLDATA channel select bits
+namespace coldata {
+    constexpr u8 BLUE  = 0x80;
+    constexpr u8 GREEN = 0x40;
+    constexpr u8 RED   = 0x20;
+    constexpr u8 ALL   = 0xE0;
+}
+
+// Point a channel at a table and program its target
+// Enable it with dma::hdma_enable() / dma::hdma_enable_claimed()
+template<u8 Unit, u16 Capacity>
+inline void attach(u8 channel, const Target& t, const Table<Unit, Capacity>& table) {
+    dma::hdma_setup_direct(channel, t.dest, table.bytes, t.mode);
+}
+
+// ============================================================================
+// Effect Builders
+// ============================================================================
+
+// Step evenly from `from` to `to` over line_count scanlines, holding each
+// value for an equal share of the lines; or_bits is ORed into every value
+// Uses only additions, so it is cheap enough to run per frame
+template<u16 Capacity>
+constexpr bool ramp(Table<1, Capacity>& t, u8 from, u8 to, u16 line_count, u8 or_bits = 0) {
+    u16 steps = static_cast<u16>((from < to ? to - from : from - to) + 1);
+    u8 v = from;
+    u16 acc = 0;
+    for (u16 k = 0; k < steps; k++) {
+        // Lines for this value: floor((k+1)*n/steps) - floor(k*n/steps)
+        u16 count = 0;
+        acc = static_cast<u16>(acc + line_count);
+        while (acc >= steps) {
+            acc = static_cast<u16>(acc - steps);
+            count++;
+        }
+        if (count != 0 && !t.hold(count, static_cast<u8>(v | or_bits))) return false;
+        v = static_cast<u8>(from < to ? v + 1 : v - 1);
+    }
+    return true;
+}
+
+// Fixed-color gradient for color math (intensity 0-31)
+// channels: coldata:: bits selecting which components change
+template<u16 Capacity>
+constexpr bool gradient(Table<1, Capacity>& t, u8 from, u8 to, u16 line_count,
+                        u8 channels = coldata::ALL) {
+    return ramp(t, static_cast<u8>(from & 0x1F), static_cast<u8>(to & 0x1F),
+                line_count, channels);
+}
+
+// Brightness fade down the screen (0-15)
+template<u16 Capacity>
+constexpr bool fade(Table<1, Capacity>& t, u8 from, u8 to, u16 line_count) {
+    return ramp(t, static_cast<u8>(from & 0x0F), static_cast<u8>(to & 0x0F), line_count);
+}
+
+// Horizontal scroll band for parallax
+struct Band {
+    u8 lines;    // Scanlines in this band
+    u16 scroll;  // Scroll value for the band
+};
+
+// One scroll value per band, top to bottom
+template<u16 Capacity>
+constexpr bool parallax(Table<2, Capacity>& t, const Band* bands, u8 count) {
+    for (u8 i = 0; i < count; i++) {
+        if (!t.hold(bands[i].lines, bands[i].scroll)) return false;
+    }
+    return true;
+}
+
+// Window edges for the next scanline (use with target::WINDOW1/WINDOW2)
+// left > right hides the window on that line
+template<u16 Capacity>
+constexpr bool window_line(Table<2, Capacity>& t, u8 left, u8 right) {
+    return t.line(static_cast<u32>(left) | (static_cast<u32>(right) << 8));
+}
+
+// ============================================================================
+// Double Buffering
+// ============================================================================
+
+// Two tables for an effect rebuilt every frame. HDMA reloads its table
+// address at the top of each frame, so the front table must not change while
+// it is on screen; build the back table instead and swap in VBlank.
+// Plain data with no constructor: call reset() before first use
+template<typename T>
+struct DoubleBuffer {
+    T tables[2];
+    u8 front;      // Table HDMA is reading
+    bool pending;  // Back table presented, waiting for commit()
+
+    void reset() {
+        tables[0].reset();
+        tables[1].reset();
+        front = 0;
+        pending = false;
+    }
+
+    // Table to rebuild (leave alone between present() and commit())
+    T& back() { return tables[front ^ 1]; }
+
+    // Table currently on screen
+    const T& active() const { return tables[front]; }
+
+    // Mark the back table complete
+    void present() { pending = true; }
+
+    // Swap in the presented table by repointing the channel
+    // Call in VBlank; returns false if nothing was presented
+    bool commit(u8 channel) {
+        if (!pending) return false;
+        front ^= 1;
+        pending = false;
+        dma::set_source(channel, reinterpret_cast<u32>(tables[front].bytes));
+        return true;
+    }
+};
+
+} // namespace snes::hdma
@@ -6,6 +6,7 @@
 #include "types.hpp"
 #include "hal.hpp"
 #include "registers.hpp"
+#include "vblank.hpp"
 
 namespace snes::input {
 
@@ -50,12 +51,88 @@ inline void enable_joypad() {
 
 // Wait for joypad auto-read to complete
 // Must call after VBlank before reading joypad registers
+// (not needed with install_latch(), which waits inside the NMI handler)
 inline void wait_for_joypad() {
     // Simple busy wait - check bit 0 of HVBJOY
     volatile u8* hvbjoy = reinterpret_cast<volatile u8*>(0x4212);
     while (*hvbjoy & 0x01) {}
 }
 
+// ============================================================================
+// NMI Input Latch (per-frame snapshot history)
+// ============================================================================
+
+// With install_latch(), the NMI handler copies both pads into a ring of
+// per-frame snapshots once auto-read has finished. Joypad::update() then
+// reads the ring instead of the hardware: no register access, no busy-wait
+// in the main loop, and no race with an auto-read in progress. Frames the
+// game missed (lag frames) stay in the ring, so presses during them are
+// still seen by the next update().
+
+// Snapshots kept (power of two); update() looks back at most
+// HISTORY_FRAMES - 1 frames, since the NMI may be overwriting the oldest
+constexpr u8 HISTORY_FRAMES = 8;
+
+struct JoypadLatch {
+    u16 buttons[HISTORY_FRAMES][2];  // Per frame, pads 0 and 1
+    volatile u16 count;              // Snapshots taken (newest = count - 1)
+    bool enabled;                    // install_latch() is active
+
+    // Buttons of pad `id` in snapshot number `frame` (count - 1 = newest)
+    u16 at(u16 frame, u8 id) const {
+        return buttons[frame & (HISTORY_FRAMES - 1)][id & 1];
+    }
+
+    // Buttons of pad `id` frames_ago snapshots back (0 = newest)
+    u16 history(u8 id, u8 frames_ago) const {
+        return at(static_cast<u16>(count - 1 - frames_ago), id);
+    }
+};
+
+#ifdef SNES_TESTING
+// For unit tests, this is defined in src/input.cpp
+extern JoypadLatch g_latch;
+#else
+inline JoypadLatch g_latch;
+#endif
+
+// Clear the snapshot ring and go back to hardware reads
+// g_latch is in BSS, which crt0 does not zero, so snes::init() calls this
+// before anything reads it; call it yourself if you skip snes::init()
+inline void reset_latch() {
+    for (u8 i = 0; i < HISTORY_FRAMES; i++) {
+        g_latch.buttons[i][0] = 0;
+        g_latch.buttons[i][1] = 0;
+    }
+    g_latch.count = 0;
+    g_latch.enabled = false;
+}
+
+// Take one snapshot of both pads (NMI handler / VBlank hook)
+// Waits for auto-read, which finishes about 3 scanlines into VBlank, so
+// install it after hooks that do VBlank DMA
+inline void latch() {
+    while (hal::read8(reg::HVBJOY::address) & 0x01) {}
+    u8 slot = static_cast<u8>(g_latch.count & (HISTORY_FRAMES - 1));
+    g_latch.buttons[slot][0] = read_joy1();
+    g_latch.buttons[slot][1] = read_joy2();
+    g_latch.count = static_cast<u16>(g_latch.count + 1);
+}
+
+// Latch the pads every frame from the NMI handler
+// Returns false if no VBlank hook slot is free
+inline bool install_latch() {
+    if (!vblank::add_hook(latch)) return false;
+    g_latch.enabled = true;
+    return true;
+}
+
+// Go back to reading the hardware in Joypad::update()
+inline void uninstall_latch() {
+    vblank::remove_hook(latch);
+    g_latch.enabled = false;
+}
+
 // ============================================================================
 // Button Masks - High Byte (joy1h / joy2h)
 // ============================================================================
@@ -139,6 +216,124 @@ enum class Direction : u8 {
     UpLeft     = 8
 };
 
+// ============================================================================
+// Input Recording / Replay
+// ============================================================================
+
+// Joypad::update() results as a run-length stream, so a benchmark can play
+// exactly the same frames on every build:
+//   [count 1-255] [held lo] [held hi] [pressed lo] [pressed hi]
+//                 [released lo] [released hi]        repeated
+//   [0]                                               end of stream
+// The edge masks belong to the first frame of a run; the rest of the run
+// has none. They are stored rather than recomputed because with the NMI
+// latch a tap during lag frames is pressed and released in one update()
+// without ever showing up as held. An idle minute is about 100 bytes.
+//
+// The stream is plain bytes with no pointers. Save Recorder::buf
+// (bytes() long) as a file, and the emulator runner injects it before
+// the program starts:
+//   w65816-runner --load run.inp@0x0400 bench.bin
+// Here 0x0400 is the replay buffer's address from the linker map (bank 0,
+// which is all the runner models). The program then calls
+// Player::begin() on that buffer.
+
+// One update() worth of input
+struct Frame {
+    u16 buttons;   // Held
+    u16 pressed;   // Pressed since the previous update()
+    u16 released;  // Released since the previous update()
+};
+
+// Bytes per run: count plus three masks
+constexpr u8 RUN_BYTES = 7;
+
+// Plain data with no constructor: call begin() before first use
+struct Recorder {
+    u8* buf;
+    u16 capacity;  // Bytes, including the end marker
+    u16 size;      // Bytes used, not counting the end marker
+    u16 run_at;    // Header of the open run, or capacity if none
+    bool overflow; // Ran out of space; frames after that were dropped
+
+    void begin(u8* buffer, u16 buffer_size) {
+        buf = buffer;
+        capacity = buffer_size;
+        size = 0;
+        run_at = buffer_size;
+        overflow = buffer_size == 0;
+        if (!overflow) buf[0] = 0;
+    }
+
+    // Append one frame
+    void push(u16 buttons, u16 pressed, u16 released) {
+        if (overflow) return;
+        if (run_at != capacity && buf[run_at] < 255 && pressed == 0 && released == 0 &&
+            (buf[run_at + 1] | (buf[run_at + 2] << 8)) == buttons) {
+            buf[run_at]++;
+            return;
+        }
+        if (size + RUN_BYTES + 1 > capacity) {
+            overflow = true;
+            return;
+        }
+        run_at = size;
+        buf[size++] = 1;
+        buf[size++] = static_cast<u8>(buttons & 0xFF);
+        buf[size++] = static_cast<u8>(buttons >> 8);
+        buf[size++] = static_cast<u8>(pressed & 0xFF);
+        buf[size++] = static_cast<u8>(pressed >> 8);
+        buf[size++] = static_cast<u8>(released & 0xFF);
+        buf[size++] = static_cast<u8>(released >> 8);
+        buf[size] = 0;
+    }
+
+    // Stream length including the end marker
+    u16 bytes() const { return static_cast<u16>(size + 1); }
+};
+
+// Plain data with no constructor: call begin() before first use
+struct Player {
+    const u8* data;
+    u16 pos;      // Next run header
+    u8 left;      // Frames left in the current run
+    u16 buttons;  // Buttons of the current run
+
+    void begin(const u8* stream) {
+        data = stream;
+        pos = 0;
+        left = 0;
+        buttons = 0;
+    }
+
+    // No frames left (replay then reports no buttons)
+    bool finished() const { return left == 0 && data[pos] == 0; }
+
+    // Input for the next frame
+    // Past the end, everything still held is released once
+    Frame next() {
+        Frame f;
+        f.pressed = 0;
+        f.released = 0;
+        if (left == 0) {
+            if (data[pos] == 0) {
+                f.released = buttons;
+                buttons = 0;
+                f.buttons = 0;
+                return f;
+            }
+            left = data[pos];
+            buttons = static_cast<u16>(data[pos + 1] | (data[pos + 2] << 8));
+            f.pressed = static_cast<u16>(data[pos + 3] | (data[pos + 4] << 8));
+            f.released = static_cast<u16>(data[pos + 5] | (data[pos + 6] << 8));
+            pos = static_cast<u16>(pos + RUN_BYTES);
+        }
+        left--;
+        f.buttons = buttons;
+        return f;
+    }
+};
+
 // ============================================================================
 // Joypad Class (stateful input handling with edge detection)
 // ============================================================================
@@ -147,22 +342,57 @@ class Joypad {
     u8 m_id;          // Joypad index (0 or 1)
     u16 m_current;    // Current frame button state
     u16 m_previous;   // Previous frame button state
+    u16 m_pressed;    // Buttons pressed since the last update()
+    u16 m_released;   // Buttons released since the last update()
+    u16 m_seen;       // Latch snapshots consumed (see g_latch)
+    Recorder* m_recorder;
+    Player* m_player;
 
 public:
     // Construct for joypad 0 or 1
-    explicit Joypad(u8 id = 0) : m_id(id), m_current(0), m_previous(0) {}
+    explicit Joypad(u8 id = 0)
+        : m_id(id), m_current(0), m_previous(0), m_pressed(0), m_released(0),
+          m_seen(g_latch.count), m_recorder(nullptr), m_player(nullptr) {}
 
     // Update button state (call once per frame)
+    // Reads the NMI latch when install_latch() is active, else the hardware;
+    // a replay overrides both, and a recorder logs the result
     void update() {
         m_previous = m_current;
 
-        // Read from hardware based on joypad ID
-        u32 addr_lo = 0x4218 + (m_id * 2);
-        u32 addr_hi = addr_lo + 1;
+        if (m_player != nullptr) {
+            Frame f = m_player->next();
+            m_current = f.buttons;
+            m_pressed = f.pressed;
+            m_released = f.released;
+        } else if (g_latch.enabled) {
+            update_from_latch();
+        } else {
+            // Read from hardware based on joypad ID
+            u32 addr_lo = 0x4218 + (m_id * 2);
+            u32 addr_hi = addr_lo + 1;
+
+            u8 lo = hal::read8(addr_lo);
+            u8 hi = hal::read8(addr_hi);
+            m_current = static_cast<u16>((hi << 8) | lo);
+            m_pressed = static_cast<u16>(m_current & ~m_previous);
+            m_released = static_cast<u16>(~m_current & m_previous);
+        }
+
+        if (m_recorder != nullptr) m_recorder->push(m_current, m_pressed, m_released);
+    }
+
+    // Log every update() to recorder (nullptr stops recording)
+    void record(Recorder* recorder) { m_recorder = recorder; }
+
+    // Take buttons from player instead of the pad (nullptr stops replay)
+    void replay(Player* player) { m_player = player; }
+
+    bool replaying() const { return m_player != nullptr; }
 
-        u8 lo = hal::read8(addr_lo);
-        u8 hi = hal::read8(addr_hi);
-        m_current = static_cast<u16>((hi << 8) | lo);
+    // Snapshots since the last update() (0 when no frame has passed)
+    u16 frames_since_update() const {
+        return static_cast<u16>(g_latch.count - m_seen);
     }
 
     // Get raw button state
@@ -184,15 +414,14 @@ public:
     }
 
     // Check if button was just pressed this frame (edge detection)
+    // With the latch, this includes presses during lag frames
     bool pressed(Button btn) const {
-        u16 mask = static_cast<u16>(btn);
-        return (m_current & mask) != 0 && (m_previous & mask) == 0;
+        return (m_pressed & static_cast<u16>(btn)) != 0;
     }
 
     // Check if button was just released this frame (edge detection)
     bool released(Button btn) const {
-        u16 mask = static_cast<u16>(btn);
-        return (m_current & mask) == 0 && (m_previous & mask) != 0;
+        return (m_released & static_cast<u16>(btn)) != 0;
     }
 
     // Get current D-pad direction (8-way + none)
@@ -241,6 +470,29 @@ public:
         if (down && !up) return 1;
         return 0;
     }
+
+private:
+    // Walk every snapshot since the last update, oldest first, collecting
+    // edges so a tap shorter than a lag frame is not lost
+    void update_from_latch() {
+        u16 newest = g_latch.count;
+        u16 first = m_seen;
+        if (static_cast<u16>(newest - first) > HISTORY_FRAMES - 1) {
+            first = static_cast<u16>(newest - (HISTORY_FRAMES - 1));
+        }
+
+        u16 state = m_current;
+        m_pressed = 0;
+        m_released = 0;
+        for (u16 f = first; f != newest; f++) {
+            u16 next = g_latch.at(f, m_id);
+            m_pressed |= static_cast<u16>(next & ~state);
+            m_released |= static_cast<u16>(~next & state);
+            state = next;
+        }
+        m_current = state;
+        m_seen = newest;
+    }
 };
 
 } // namespace snes::input
@@ -1,13 +1,90 @@
 #pragma once
 
 // SNES Math API - Header-only math utilities for W65816 backend
-// Includes angle/trig functions, min/max/clamp, lerp, random number generation
+// Includes angle/trig functions, min/max/clamp, lerp, random number generation,
+// compile-time lookup tables and the CPU's hardware multiply/divide unit
 
 #include "types.hpp"
+#include "hal.hpp"
+#include "registers.hpp"
+
+// Place a lookup table in a ROM bank other than the default RODATA
+// (BANKn_RODATA segments, see linker_configs/lorom-multibank.cfg):
+//   SNES_LUT_BANK(2) inline constexpr auto kRecip = math::make_lut<u16, 256>(math::lut::reciprocal);
+// Data outside bank 0 must be read with long (24-bit) addressing.
+#ifdef SNES_TESTING
+#define SNES_LUT_BANK(n)
+#else
+#define SNES_LUT_BANK(n) __attribute__((section("BANK" #n "_RODATA")))
+#endif
 
 namespace snes {
 namespace math {
 
+// ============================================================================
+// Lookup Tables
+// ============================================================================
+
+// Table of N precomputed values. Declared constexpr, it is generated by the
+// compiler and lands in ROM, so a runtime lookup is a single indexed load.
+template<typename T, u16 N>
+struct Lut {
+    static constexpr u16 size = N;
+
+    T v[N];
+
+    constexpr const T& operator[](u16 i) const { return v[i]; }
+};
+
+// Fill a table with fn(0) .. fn(N - 1); fn must be usable in constant
+// expressions (a constexpr function or capture-free lambda)
+//   inline constexpr auto kEase = math::make_lut<u8, 64>(math::lut::ease_in<64>);
+template<typename T, u16 N, typename Fn>
+constexpr Lut<T, N> make_lut(Fn fn) {
+    Lut<T, N> t{};
+    for (u16 i = 0; i < N; i++) {
+        t.v[i] = static_cast<T>(fn(i));
+    }
+    return t;
+}
+
+// Generators for make_lut. They use 64-bit math and are meant for compile
+// time only.
+namespace lut {
+
+// 65536 / n, saturating to 0xFFFF for n = 0, 1 (perspective, distances)
+constexpr u16 reciprocal(u16 n) {
+    return n <= 1 ? static_cast<u16>(0xFFFF) : static_cast<u16>(65536ULL / n);
+}
+
+// Easing curves from 0 to 255 over N entries (N >= 2)
+template<u16 N>
+constexpr u8 ease_in(u16 i) {
+    unsigned long long d = N - 1;
+    return static_cast<u8>(255ULL * i * i / (d * d));
+}
+
+template<u16 N>
+constexpr u8 ease_out(u16 i) {
+    return static_cast<u8>(255 - ease_in<N>(static_cast<u16>(N - 1 - i)));
+}
+
+// 3t^2 - 2t^3
+template<u16 N>
+constexpr u8 smoothstep(u16 i) {
+    unsigned long long d = N - 1;
+    unsigned long long x = i;
+    return static_cast<u8>(255ULL * x * x * (3 * d - 2 * x) / (d * d * d));
+}
+
+// Palette fade: entry (level << 5) | c is color component c (0-31) at
+// brightness level (0-15), so a 512-entry table replaces c * level / 15
+constexpr u8 fade(u16 i) {
+    return static_cast<u8>((i & 0x1F) * (i >> 5) / 15);
+}
+
+} // namespace lut
+
 // ============================================================================
 // Angle (256-unit circle, 1 byte = full rotation)
 // ============================================================================
@@ -52,9 +129,6 @@ struct Angle {
 // Sine/Cosine Lookup Tables (256 entries, 8.8 fixed point)
 // ============================================================================
 
-// Sine table for quarter circle (64 entries), values in 8.8 fixed point
-// sin(0) to sin(90 degrees) mapped to 0-64 indices
-// Full table would be 256 entries but we use symmetry
 namespace detail {
 
 // Quarter sine table (0-64, representing 0-90 degrees)
@@ -67,33 +141,79 @@ constexpr i16 sin_quarter[65] = {
    256
 };
 
+// Full-period sine, unfolded from the quarter table
+constexpr i16 sin_unfold(u16 i) {
+    u8 idx = static_cast<u8>(i & 0xFF);
+    if (idx < 64) return sin_quarter[idx];
+    if (idx < 128) return sin_quarter[128 - idx];
+    if (idx < 192) return static_cast<i16>(-sin_quarter[idx - 128]);
+    return static_cast<i16>(-sin_quarter[256 - idx]);
+}
+
+// 256 + 64 entries so cos() can index a quarter turn ahead without wrapping
+inline constexpr Lut<i16, 256 + 64> sin_table = make_lut<i16, 256 + 64>(sin_unfold);
+
+// atan(k / 64) in angle units (0-32) for k = 0-64
+constexpr u8 atan_table[65] = {
+     0,  1,  1,  2,  3,  3,  4,  4,  5,  6,  6,  7,  8,  8,  9,  9,
+    10, 11, 11, 12, 12, 13, 13, 14, 15, 15, 16, 16, 17, 17, 18, 18,
+    19, 19, 20, 20, 21, 21, 22, 22, 23, 23, 24, 24, 25, 25, 25, 26,
+    26, 27, 27, 27, 28, 28, 29, 29, 29, 30, 30, 30, 31, 31, 31, 32,
+    32
+};
+
+// floor(num * 64 / den) for num <= den, by 6 steps of shift-and-subtract
+// (den <= 32768, so the doubled remainder always fits in 16 bits)
+constexpr u8 ratio64(u16 num, u16 den) {
+    if (num >= den) return 64;
+    u8 q = 0;
+    for (u8 i = 0; i < 6; i++) {
+        num = static_cast<u16>(num << 1);
+        q = static_cast<u8>(q << 1);
+        if (num >= den) {
+            num = static_cast<u16>(num - den);
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+// |v| as unsigned, including -32768
+constexpr u16 magnitude(i16 v) {
+    return v < 0 ? static_cast<u16>(0u - static_cast<u16>(v)) : static_cast<u16>(v);
+}
+
 } // namespace detail
 
 // Sin function using lookup table (returns 8.8 fixed point)
 inline Fixed8 sin(Angle a) {
-    u8 idx = a.raw;
-    i16 val;
-
-    if (idx < 64) {
-        // First quadrant: 0-63 -> sin is positive, increasing
-        val = detail::sin_quarter[idx];
-    } else if (idx < 128) {
-        // Second quadrant: 64-127 -> sin is positive, decreasing
-        val = detail::sin_quarter[128 - idx];
-    } else if (idx < 192) {
-        // Third quadrant: 128-191 -> sin is negative, increasing magnitude
-        val = -detail::sin_quarter[idx - 128];
-    } else {
-        // Fourth quadrant: 192-255 -> sin is negative, decreasing magnitude
-        val = -detail::sin_quarter[256 - idx];
-    }
-
-    return Fixed8(val);
+    return Fixed8(detail::sin_table.v[a.raw]);
 }
 
 // Cos function (sin shifted by 90 degrees)
 inline Fixed8 cos(Angle a) {
-    return sin(Angle(static_cast<u8>((a.raw + 64) & 0xFF)));
+    return Fixed8(detail::sin_table.v[a.raw + 64]);
+}
+
+// Angle of the vector (x, y): 0 along +x, 64 along +y (same convention as
+// sin/cos, so sin(atan2(y, x)) has the sign of y)
+// Accurate to about 1 unit (1.4 degrees); atan2(0, 0) is 0
+inline Angle atan2(i16 y, i16 x) {
+    u16 ax = detail::magnitude(x);
+    u16 ay = detail::magnitude(y);
+    if (ax == 0 && ay == 0) return Angle(0);
+
+    // Angle within the first quadrant from the octant's ratio
+    u8 a;
+    if (ay <= ax) {
+        a = detail::atan_table[detail::ratio64(ay, ax)];
+    } else {
+        a = static_cast<u8>(64 - detail::atan_table[detail::ratio64(ax, ay)]);
+    }
+
+    if (x < 0) a = static_cast<u8>(128 - a);
+    if (y < 0) a = static_cast<u8>(0 - a);
+    return Angle(a);
 }
 
 // ============================================================================
@@ -129,6 +249,139 @@ constexpr i16 sign(i16 v) {
     return 0;
 }
 
+// ============================================================================
+// Hardware Multiply / Divide
+// ============================================================================
+
+// The CPU has an unsigned 8x8 multiplier ($4202/$4203 -> $4216) and a
+// 16/8 divider ($4204-$4206 -> $4214/$4216). Writing the last operand
+// starts the unit; the result is ready MUL_CYCLES / DIV_CYCLES CPU cycles
+// later. The *_start()/result pairs let other work cover that latency:
+//
+//   hw::div_start(total, count);
+//   update_sprites();             // at least 16 cycles of unrelated work
+//   u16 average = hw::div_quotient();
+//
+// The two units share RDMPY (product or remainder), so only one operation
+// can be in flight. Neither is safe to use from both the main loop and the
+// NMI handler. The blocking helpers (mul8, mul16, div) wait for you.
+namespace hw {
+
+constexpr u8 MUL_CYCLES = 8;
+constexpr u8 DIV_CYCLES = 16;
+
+namespace detail {
+    // Each round is a volatile load, decrement and store (well over 6
+    // cycles), which the compiler cannot drop or merge
+    inline void wait(u8 rounds) {
+        volatile u8 n = rounds;
+        while (n != 0) n = static_cast<u8>(n - 1);
+    }
+}
+
+struct DivResult {
+    u16 quotient;
+    u16 remainder;
+};
+
+// Start an unsigned 8x8 multiply
+inline void mul_start(u8 a, u8 b) {
+    hal::write8(reg::WRMPYA::address, a);
+    hal::write8(reg::WRMPYB::address, b);
+}
+
+// Product of the last mul_start(), MUL_CYCLES after it
+inline u16 mul_result() {
+    return hal::read16(reg::RDMPYL::address);
+}
+
+// Start an unsigned 16/8 divide (divisor 0 gives quotient 0xFFFF)
+inline void div_start(u16 dividend, u8 divisor) {
+    reg::WRDIV::write(dividend);
+    hal::write8(reg::WRDIVB::address, divisor);
+}
+
+// Results of the last div_start(), DIV_CYCLES after it
+inline u16 div_quotient() {
+    return hal::read16(reg::RDDIVL::address);
+}
+
+inline u16 div_remainder() {
+    return hal::read16(reg::RDMPYL::address);
+}
+
+// Blocking 8x8 multiply
+inline u16 mul8(u8 a, u8 b) {
+    mul_start(a, b);
+    detail::wait(2);
+    return mul_result();
+}
+
+// Blocking 16x16 multiply from four 8x8 partial products
+inline u32 mul16(u16 a, u16 b) {
+    u8 al = static_cast<u8>(a & 0xFF);
+    u8 ah = static_cast<u8>(a >> 8);
+    u8 bl = static_cast<u8>(b & 0xFF);
+    u8 bh = static_cast<u8>(b >> 8);
+    u32 result = mul8(al, bl);
+    result += static_cast<u32>(mul8(ah, bl)) << 8;
+    result += static_cast<u32>(mul8(al, bh)) << 8;
+    result += static_cast<u32>(mul8(ah, bh)) << 16;
+    return result;
+}
+
+// Blocking 16/8 divide
+inline DivResult div(u16 dividend, u8 divisor) {
+    div_start(dividend, divisor);
+    detail::wait(3);
+    DivResult r;
+    r.quotient = div_quotient();
+    r.remainder = div_remainder();
+    return r;
+}
+
+// Fixed point multiply for 16-bit formats; same result as operator*
+template<u8 I, u8 F>
+inline Fixed<I, F, i16> mul(Fixed<I, F, i16> a, Fixed<I, F, i16> b) {
+    bool negative = (a.raw < 0) != (b.raw < 0);
+    u16 ma = a.raw < 0 ? static_cast<u16>(0u - static_cast<u16>(a.raw)) : static_cast<u16>(a.raw);
+    u16 mb = b.raw < 0 ? static_cast<u16>(0u - static_cast<u16>(b.raw)) : static_cast<u16>(b.raw);
+    i32 product = static_cast<i32>(mul16(ma, mb));
+    if (negative) product = -product;
+    return Fixed<I, F, i16>(static_cast<i16>(product >> F));
+}
+
+// Fixed point multiply for 8-bit formats: a single 8x8 product
+template<u8 I, u8 F>
+inline Fixed<I, F, i8> mul(Fixed<I, F, i8> a, Fixed<I, F, i8> b) {
+    bool negative = (a.raw < 0) != (b.raw < 0);
+    u8 ma = a.raw < 0 ? static_cast<u8>(0u - static_cast<u8>(a.raw)) : static_cast<u8>(a.raw);
+    u8 mb = b.raw < 0 ? static_cast<u8>(0u - static_cast<u8>(b.raw)) : static_cast<u8>(b.raw);
+    i16 product = static_cast<i16>(mul8(ma, mb));
+    if (negative) product = static_cast<i16>(-product);
+    return Fixed<I, F, i8>(static_cast<i8>(product >> F));
+}
+
+// Fixed8 divide; same result as Fixed8::operator/
+// Uses the divider when |b| < 1.0 (raw -255..255), software otherwise
+inline Fixed8 div(Fixed8 a, Fixed8 b) {
+    u16 mb = b.raw < 0 ? static_cast<u16>(0u - static_cast<u16>(b.raw)) : static_cast<u16>(b.raw);
+    if (mb == 0 || mb > 0xFF) return a / b;
+
+    bool negative = (a.raw < 0) != (b.raw < 0);
+    u16 ma = a.raw < 0 ? static_cast<u16>(0u - static_cast<u16>(a.raw)) : static_cast<u16>(a.raw);
+
+    // (ma << 8) / mb as two 16/8 steps; the remainder is below mb, so the
+    // second dividend fits in 16 bits
+    DivResult hi = div(ma, static_cast<u8>(mb));
+    DivResult lo = div(static_cast<u16>(hi.remainder << 8), static_cast<u8>(mb));
+    i32 q = static_cast<i32>((static_cast<u32>(hi.quotient) << 8) + lo.quotient);
+    if (negative) q = -q;
+    return Fixed8(static_cast<i16>(q));
+}
+
+} // namespace hw
+
 // ============================================================================
 // Linear Interpolation
 // ============================================================================
@@ -149,6 +402,20 @@ inline Fixed8 lerp(Fixed8 a, Fixed8 b, u8 t) {
     return Fixed8(static_cast<i16>(a.raw + (diff * t) / 256));
 }
 
+// Lerp on the hardware multiplier; same result as lerp()
+inline i16 lerp_hw(i16 a, i16 b, u8 t) {
+    i32 diff = static_cast<i32>(b) - static_cast<i32>(a);
+    u16 mag = static_cast<u16>(diff < 0 ? -diff : diff);  // At most 65535
+    u32 scaled = hw::mul8(static_cast<u8>(mag & 0xFF), t) +
+                 (static_cast<u32>(hw::mul8(static_cast<u8>(mag >> 8), t)) << 8);
+    i32 step = static_cast<i32>(scaled >> 8);
+    return static_cast<i16>(a + (diff < 0 ? -step : step));
+}
+
+inline Fixed8 lerp_hw(Fixed8 a, Fixed8 b, u8 t) {
+    return Fixed8(lerp_hw(a.raw, b.raw, t));
+}
+
 // ============================================================================
 // Distance (squared, to avoid sqrt)
 // ============================================================================
@@ -161,24 +428,116 @@ constexpr i32 dist_sq(i16 x1, i16 y1, i16 x2, i16 y2) {
 }
 
 // ============================================================================
-// Random Number Generator (LFSR-based)
+// Approximate Magnitude
+// ============================================================================
+
+// Length of (dx, dy) without a square root: max(hi, 7/8 hi + 1/2 lo) where
+// hi/lo are the larger/smaller of |dx| and |dy|. Within about 3.3% of the
+// true length (plus integer truncation for very short vectors).
+constexpr u16 magnitude(i16 dx, i16 dy) {
+    u16 ax = detail::magnitude(dx);
+    u16 ay = detail::magnitude(dy);
+    u16 hi = ax > ay ? ax : ay;
+    u16 lo = ax > ay ? ay : ax;
+    u16 est = static_cast<u16>(hi - (hi >> 3) + (lo >> 1));
+    return est > hi ? est : hi;
+}
+
+// Approximate vector length (saturates at the largest Fixed8)
+inline Fixed8 length(Vec2 v) {
+    u16 m = magnitude(v.x.raw, v.y.raw);
+    return Fixed8(static_cast<i16>(m > 0x7FFF ? 0x7FFF : m));
+}
+
+// Unit vector in the direction of v, from atan2 and the sine table
+// (direction accurate to about 1.4 degrees); a zero vector gives (1, 0)
+inline Vec2 normalize(Vec2 v) {
+    Angle a = atan2(v.y.raw, v.x.raw);
+    return Vec2(cos(a), sin(a));
+}
+
+// ============================================================================
+// Random Number Generators
 // ============================================================================
 
-class Random {
+// Engines share one interface: seed(u16) and u16 next(). Seed 0 would lock
+// every engine at 0, so it is replaced with a fixed non-zero value.
+namespace rng {
+
+constexpr u16 DEFAULT_SEED = 0xACE1;
+
+// 16-bit Fibonacci LFSR, taps 16, 14, 13, 11 (period 65535)
+// Advances one bit per call: consecutive values are shifted copies of
+// each other, so prefer Xorshift or ByteLfsr when outputs must differ
+struct Lfsr {
     u16 state;
 
-public:
-    // Construct with seed (0 is automatically replaced with non-zero)
-    explicit Random(u16 seed = 1) : state(seed ? seed : 0xACE1) {}
+    void seed(u16 s) { state = s ? s : DEFAULT_SEED; }
 
-    // Get next random value (full 16-bit range)
     u16 next() {
-        // 16-bit LFSR with taps at 16, 14, 13, 11
-        // Polynomial: x^16 + x^14 + x^13 + x^11 + 1
         u16 bit = ((state >> 0) ^ (state >> 2) ^ (state >> 3) ^ (state >> 5)) & 1;
-        state = (state >> 1) | (bit << 15);
+        state = static_cast<u16>((state >> 1) | (bit << 15));
+        return state;
+    }
+};
+
+// 16-bit xorshift (7, 9, 8), period 65535; three shift/xor steps per call
+struct Xorshift {
+    u16 state;
+
+    void seed(u16 s) { state = s ? s : DEFAULT_SEED; }
+
+    u16 next() {
+        state = static_cast<u16>(state ^ (state << 7));
+        state = static_cast<u16>(state ^ (state >> 9));
+        state = static_cast<u16>(state ^ (state << 8));
+        return state;
+    }
+};
+
+namespace detail {
+
+// Galois form of Lfsr's polynomial (right shift, feedback 0xB400)
+constexpr u16 GALOIS_TAPS = 0xB400;
+
+// Eight Galois steps applied to a state whose high byte is zero
+constexpr u16 galois_byte(u16 low) {
+    u16 s = low;
+    for (u8 i = 0; i < 8; i++) {
+        s = static_cast<u16>((s & 1) ? ((s >> 1) ^ GALOIS_TAPS) : (s >> 1));
+    }
+    return s;
+}
+
+inline constexpr Lut<u16, 256> galois_byte_table = make_lut<u16, 256>(galois_byte);
+
+} // namespace detail
+
+// 16-bit Galois LFSR advanced a whole byte per call through a 256-entry
+// table (one shift, one load, one xor), period 65535
+struct ByteLfsr {
+    u16 state;
+
+    void seed(u16 s) { state = s ? s : DEFAULT_SEED; }
+
+    u16 next() {
+        state = static_cast<u16>((state >> 8) ^ detail::galois_byte_table[state & 0xFF]);
         return state;
     }
+};
+
+} // namespace rng
+
+template<typename Engine>
+class BasicRandom {
+    Engine engine;
+
+public:
+    // Construct with seed (0 is automatically replaced with non-zero)
+    explicit BasicRandom(u16 seed = 1) { engine.seed(seed); }
+
+    // Get next random value (full 16-bit range)
+    u16 next() { return engine.next(); }
 
     // Get random value in range [0, max)
     u16 range(u16 max) {
@@ -192,12 +551,46 @@ public:
         return min_val + (next() % (max_val - min_val));
     }
 
-    // Reset with new seed
-    void seed(u16 s) {
-        state = s ? s : 0xACE1;
+    // Get random value in range [0, max) using the hardware divider
+    u8 range_hw(u8 max) {
+        if (max == 0) return 0;
+        return static_cast<u8>(hw::div(next(), max).remainder);
+    }
+
+    // Get random value in range [0, max) by multiply-high: the top byte of
+    // next() times max, divided by 256 (one hardware 8x8 multiply)
+    u8 range_mul(u8 max) {
+        u8 r = static_cast<u8>(next() >> 8);
+        return static_cast<u8>(hw::mul8(r, max) >> 8);
     }
+
+    // Fill a buffer with random bytes (two per call to next())
+    void fill(u8* buf, u16 count) {
+        u16 i = 0;
+        for (; i + 1 < count; i = static_cast<u16>(i + 2)) {
+            u16 r = next();
+            buf[i] = static_cast<u8>(r & 0xFF);
+            buf[i + 1] = static_cast<u8>(r >> 8);
+        }
+        if (i < count) buf[i] = static_cast<u8>(next() >> 8);
+    }
+
+    // Fill a buffer with values in [0, max), e.g. particle spawn offsets
+    void fill_range(u8* buf, u16 count, u8 max) {
+        for (u16 i = 0; i < count; i++) buf[i] = range_mul(max);
+    }
+
+    // Reset with new seed
+    void seed(u16 s) { engine.seed(s); }
 };
 
+// Default generator (single-bit LFSR)
+using Random = BasicRandom<rng::Lfsr>;
+
+// Better-mixed alternatives with the same interface
+using XorshiftRandom = BasicRandom<rng::Xorshift>;
+using ByteRandom = BasicRandom<rng::ByteLfsr>;
+
 } // namespace math
 
 // Bring commonly used items into snes namespace for convenience
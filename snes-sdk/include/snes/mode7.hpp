@@ -0,0 +1,466 @@
+#pragma once
+
+// SNES Mode 7 API - Rotation/scale camera
+//
+// The Mode 7 matrix maps screen pixels to texels:
+//   A = cos(angle) * scale_x    B = sin(angle) * scale_x
+//   C = -sin(angle) * scale_y   D = cos(angle) * scale_y
+// with 8.8 fixed point entries (256 = 1.0). A scale above 1.0 zooms out.
+//
+// The PPU's signed multiplier (M7A x M7B -> $2134-$2136) does these products
+// much faster than a 32-bit software multiply, but it shares the matrix
+// registers, so it is only usable while the PPU is not drawing Mode 7:
+// VBlank, forced blank or another BG mode. Camera::commit() runs in VBlank,
+// computes the matrix on the PPU and writes it in one go.
+//
+// Floor generates per-scanline matrices for a perspective plane and feeds
+// them to the PPU through HDMA.
+
+#include "types.hpp"
+#include "hal.hpp"
+#include "registers.hpp"
+#include "ppu.hpp"
+#include "math.hpp"
+#include "dma.hpp"
+#include "hdma.hpp"
+
+namespace snes::mode7 {
+
+// ============================================================================
+// PPU Multiplier
+// ============================================================================
+
+// Signed 16 x 8 multiply on the PPU (24-bit result)
+// Clobbers M7A/M7B; only valid when the PPU is not drawing Mode 7
+inline i32 ppu_mul(i16 a, i8 b) {
+    hal::write8(reg::M7A::address, static_cast<u8>(a & 0xFF));
+    hal::write8(reg::M7A::address, static_cast<u8>((a >> 8) & 0xFF));
+    hal::write8(reg::M7B::address, static_cast<u8>(b));  // Multiplier uses the last byte written
+
+    u16 lo = hal::read8(reg::MPYL::address);
+    u16 mid = hal::read8(reg::MPYM::address);
+    i8 hi = static_cast<i8>(hal::read8(reg::MPYH::address));  // Sign of the 24-bit result
+    return static_cast<i32>(hi) * 65536 + static_cast<i32>(lo | (mid << 8));
+}
+
+// 8.8 x 8.8 fixed point multiply on the PPU
+// b is split into a signed high part and a 7-bit low part, so |b| must stay
+// below 64.0 (raw -16384..16383); a can use the full 16-bit range
+inline i16 ppu_mul_fixed(i16 a, i16 b) {
+    i8 hi = static_cast<i8>(b >> 7);
+    i8 lo = static_cast<i8>(b & 0x7F);
+    i32 product = ppu_mul(a, hi) * 128 + ppu_mul(a, lo);
+    return static_cast<i16>(product >> 8);
+}
+
+// ============================================================================
+// Matrix
+// ============================================================================
+
+struct Matrix {
+    i16 a;
+    i16 b;
+    i16 c;
+    i16 d;
+};
+
+// Rotation/scale matrix in software (usable at any time)
+inline Matrix matrix(Angle angle, Fixed8 scale_x, Fixed8 scale_y) {
+    Fixed8 s = math::sin(angle);
+    Fixed8 c = math::cos(angle);
+    Matrix m;
+    m.a = (c * scale_x).raw;
+    m.b = (s * scale_x).raw;
+    m.c = (-(s * scale_y)).raw;
+    m.d = (c * scale_y).raw;
+    return m;
+}
+
+// Rotation/scale matrix on the PPU multiplier
+// Only valid when the PPU is not drawing Mode 7 (see ppu_mul)
+inline Matrix matrix_ppu(Angle angle, Fixed8 scale_x, Fixed8 scale_y) {
+    i16 s = math::sin(angle).raw;
+    i16 c = math::cos(angle).raw;
+    Matrix m;
+    m.a = ppu_mul_fixed(scale_x.raw, c);
+    m.b = ppu_mul_fixed(scale_x.raw, s);
+    if (scale_y == scale_x) {
+        m.c = static_cast<i16>(-m.b);
+        m.d = m.a;
+    } else {
+        m.c = static_cast<i16>(-ppu_mul_fixed(scale_y.raw, s));
+        m.d = ppu_mul_fixed(scale_y.raw, c);
+    }
+    return m;
+}
+
+// Write the matrix to M7A-M7D
+inline void write_matrix(const Matrix& m) {
+    ppu::set_m7a(m.a);
+    ppu::set_m7b(m.b);
+    ppu::set_m7c(m.c);
+    ppu::set_m7d(m.d);
+}
+
+// ============================================================================
+// Camera
+// ============================================================================
+
+// Rotation, scale, center and scroll for the Mode 7 layer
+// Setters only record the new values; commit() applies them in VBlank
+// Plain data with no constructor: call reset() before first use
+struct Camera {
+    Angle angle;
+    Fixed8 scale_x;
+    Fixed8 scale_y;
+    i16 center_x;   // Rotation center in texels (M7X)
+    i16 center_y;   // Rotation center in texels (M7Y)
+    i16 scroll_x;   // M7HOFS
+    i16 scroll_y;   // M7VOFS
+    bool dirty;     // Changed since the last commit()
+
+    // Identity transform centered on the middle of the screen
+    void reset() {
+        angle = Angle(0);
+        scale_x = Fixed8::from_int(1);
+        scale_y = Fixed8::from_int(1);
+        center_x = 128;
+        center_y = 112;
+        scroll_x = 0;
+        scroll_y = 0;
+        dirty = true;
+    }
+
+    void set_angle(Angle a) {
+        angle = a;
+        dirty = true;
+    }
+
+    void set_scale(Fixed8 s) {
+        scale_x = s;
+        scale_y = s;
+        dirty = true;
+    }
+
+    void set_scale(Fixed8 sx, Fixed8 sy) {
+        scale_x = sx;
+        scale_y = sy;
+        dirty = true;
+    }
+
+    void set_center(i16 x, i16 y) {
+        center_x = x;
+        center_y = y;
+        dirty = true;
+    }
+
+    // Scroll so the rotation center sits at screen position (128, 112)
+    void look_at(i16 x, i16 y) {
+        center_x = x;
+        center_y = y;
+        scroll_x = static_cast<i16>(x - 128);
+        scroll_y = static_cast<i16>(y - 112);
+        dirty = true;
+    }
+
+    // Current matrix, computed in software
+    Matrix matrix() const {
+        return mode7::matrix(angle, scale_x, scale_y);
+    }
+
+    // Compute the matrix on the PPU and write all Mode 7 registers
+    // Call in VBlank (or forced blank); does nothing if unchanged
+    // Returns true if the registers were written
+    bool commit() {
+        if (!dirty) return false;
+
+        Matrix m = matrix_ppu(angle, scale_x, scale_y);
+        write_matrix(m);
+        ppu::set_m7x(center_x);
+        ppu::set_m7y(center_y);
+
+        // M7HOFS/M7VOFS share BG1HOFS/BG1VOFS (write twice)
+        hal::write8(reg::BG1HOFS::address, static_cast<u8>(scroll_x & 0xFF));
+        hal::write8(reg::BG1HOFS::address, static_cast<u8>((scroll_x >> 8) & 0xFF));
+        hal::write8(reg::BG1VOFS::address, static_cast<u8>(scroll_y & 0xFF));
+        hal::write8(reg::BG1VOFS::address, static_cast<u8>((scroll_y >> 8) & 0xFF));
+
+        dirty = false;
+        return true;
+    }
+};
+
+// ============================================================================
+// Perspective Floor
+// ============================================================================
+
+// Visible scanlines
+constexpr u8 FLOOR_LINES = 224;
+
+namespace detail {
+
+// 65536 / n for n = 1..224 (n = 0, 1 saturate), so per-line distances need
+// no division at runtime
+inline constexpr math::Lut<u16, FLOOR_LINES + 1> reciprocals =
+    math::make_lut<u16, FLOOR_LINES + 1>(math::lut::reciprocal);
+
+// (c * s) >> 8 from the 8x8 products lo = (s & 0xFF) * |c| and
+// hi = (s >> 8) * |c|, for |c| < 256 and s <= 0x7FFF. Stays in 16 bits
+// (the result is below 0x8000) and rounds like the arithmetic shift of
+// the signed product.
+inline i16 combine(u16 lo, u16 hi, bool negative) {
+    u16 q = static_cast<u16>(hi + (lo >> 8));
+    if (!negative) return static_cast<i16>(q);
+    return static_cast<i16>(0u - (q + ((lo & 0xFF) != 0 ? 1u : 0u)));
+}
+
+// (c * s) >> 8 for an 8.8 sine or cosine (|c| <= 256) and a line scale
+// (0..0x7FFF), as two 8x8 products on the CPU multiplier
+inline i16 scale_mul(i16 c, u16 s) {
+    if (c == 0) return 0;
+    u16 mc = math::detail::magnitude(c);
+    if (mc >= 256) return static_cast<i16>(c < 0 ? 0u - s : s);  // |c| = 1.0
+    u8 m = static_cast<u8>(mc);
+    return combine(math::hw::mul8(static_cast<u8>(s & 0xFF), m),
+                   math::hw::mul8(static_cast<u8>(s >> 8), m), c < 0);
+}
+
+// Little-endian table entry; volatile so the stores stay between the
+// multiplier accesses they are timed to separate
+inline void put16(volatile u8* p, i16 v) {
+    p[0] = static_cast<u8>(static_cast<u16>(v) & 0xFF);
+    p[1] = static_cast<u8>(static_cast<u16>(v) >> 8);
+}
+
+} // namespace detail
+
+// One M7A-M7D parameter per scanline: header bytes, up to two holds for the
+// lines above the horizon, 2 bytes per floor line and the end marker
+using FloorTable = hdma::Table<2, 2 * FLOOR_LINES + 8>;
+
+// F-Zero style perspective plane
+// Line y below the horizon shows the plane at distance height / (y - horizon),
+// so its scale is height * 65536 / (y - horizon) >> 8, read from a
+// reciprocal table. Lines above the horizon get a zero matrix (cover them
+// with another layer or a window).
+//
+// update() rebuilds the back tables during active display; commit() swaps
+// them in VBlank. When only the angle changes, the per-line scales are
+// reused and only the cos/sin products are redone.
+//
+// The PPU multiplier is busy with the HDMA'd matrix while the floor is
+// drawn, so update() uses the CPU multiplier instead of 32-bit software
+// multiplies: at most 4 hardware multiplies per floor line for an angle
+// change (none at multiples of 90 degrees), plus 4 per line when the scales
+// are rebuilt. Entries are written straight into the tables, and each
+// multiply's latency is covered by table stores instead of a wait loop,
+// so an angle change costs an estimated 150-160 CPU cycles per line:
+// about 35,000 for a full-screen floor, well inside a 60,000-cycle frame.
+// A scale rebuild adds a 16x16 multiply per line and can take longer;
+// change height or horizon sparingly.
+// Don't call it while the NMI handler uses the multiplier.
+//
+//   floor.reset();
+//   floor.claim_channels();
+//   floor.set_camera(40, 64);
+//   loop:
+//       floor.set_angle(player_angle);
+//       floor.update();
+//       vblank: floor.commit(); mode7 camera center/scroll as usual
+//
+// Plain data with no constructor: call reset() before first use
+struct Floor {
+    hdma::DoubleBuffer<FloorTable> ad;  // M7A and M7D (identical)
+    hdma::DoubleBuffer<FloorTable> b;   // M7B
+    hdma::DoubleBuffer<FloorTable> c;   // M7C (= -M7B)
+    i16 scale[FLOOR_LINES];             // 8.8 scale per line (below horizon)
+    u16 height;                         // Camera height in texels
+    u8 horizon;                         // Screen line of the horizon
+    Angle angle;
+    bool scale_dirty;                   // Height or horizon changed
+    bool angle_dirty;                   // Angle changed
+    u8 channels[4];                     // HDMA channels for M7A-M7D
+
+    void reset() {
+        ad.reset();
+        b.reset();
+        c.reset();
+        height = 32;
+        horizon = 0;
+        angle = Angle(0);
+        scale_dirty = true;
+        angle_dirty = true;
+        for (u8 i = 0; i < 4; i++) channels[i] = dma::NO_CHANNEL;
+    }
+
+    // height: camera height in texels
+    // horizon: screen line where the plane meets the sky; pitching the
+    // camera down moves it up the screen (0-223)
+    void set_camera(u16 cam_height, u8 horizon_line) {
+        if (cam_height == height && horizon_line == horizon) return;
+        height = cam_height;
+        horizon = horizon_line < FLOOR_LINES ? horizon_line : FLOOR_LINES - 1;
+        scale_dirty = true;
+    }
+
+    void set_angle(Angle a) {
+        if (a == angle) return;
+        angle = a;
+        angle_dirty = true;
+    }
+
+    // Use the given channels for M7A-M7D and program them
+    void attach(u8 ch_a, u8 ch_b, u8 ch_c, u8 ch_d) {
+        channels[0] = ch_a;
+        channels[1] = ch_b;
+        channels[2] = ch_c;
+        channels[3] = ch_d;
+
+        // Mode 2: both bytes of each entry go to the same write-twice register
+        dma::hdma_setup_direct(ch_a, 0x1B, ad.active().bytes, 0x02);
+        dma::hdma_setup_direct(ch_b, 0x1C, b.active().bytes, 0x02);
+        dma::hdma_setup_direct(ch_c, 0x1D, c.active().bytes, 0x02);
+        dma::hdma_setup_direct(ch_d, 0x1E, ad.active().bytes, 0x02);
+    }
+
+    // Claim four HDMA channels from dma::g_channels and attach to them
+    // Returns false (claiming nothing) if four are not available
+    bool claim_channels() {
+        u8 ch[4];
+        for (u8 i = 0; i < 4; i++) {
+            ch[i] = dma::g_channels.claim_hdma();
+            if (ch[i] == dma::NO_CHANNEL) {
+                while (i-- > 0) dma::g_channels.release_hdma(ch[i]);
+                return false;
+            }
+        }
+        attach(ch[0], ch[1], ch[2], ch[3]);
+        return true;
+    }
+
+    // HDMAEN bits for the attached channels
+    u8 channel_mask() const {
+        u8 mask = 0;
+        for (u8 i = 0; i < 4; i++) {
+            if (channels[i] != dma::NO_CHANNEL) mask |= dma::channel_bit(channels[i]);
+        }
+        return mask;
+    }
+
+    // Rebuild the back tables if anything changed and present them
+    // Run during active display; returns false if nothing changed
+    bool update() {
+        if (!scale_dirty && !angle_dirty) return false;
+
+        if (scale_dirty) {
+            for (u8 y = static_cast<u8>(horizon + 1); y < FLOOR_LINES; y++) {
+                u32 s = math::hw::mul16(height, detail::reciprocals.v[y - horizon]) >> 8;
+                scale[y] = static_cast<i16>(s > 0x7FFF ? 0x7FFF : s);
+            }
+        }
+
+        i16 cs = math::cos(angle).raw;
+        i16 sn = math::sin(angle).raw;
+
+        FloorTable& ta = ad.back();
+        FloorTable& tb = b.back();
+        FloorTable& tc = c.back();
+        ta.reset();
+        tb.reset();
+        tc.reset();
+
+        // Horizon line and above: zero matrix
+        ta.hold(static_cast<u16>(horizon + 1), 0);
+        tb.hold(static_cast<u16>(horizon + 1), 0);
+        tc.hold(static_cast<u16>(horizon + 1), 0);
+
+        // Repeat-mode runs of up to 127 lines, filled in place
+        u8 y = static_cast<u8>(horizon + 1);
+        while (y < FLOOR_LINES) {
+            u8 n = static_cast<u8>(FLOOR_LINES - y);
+            if (n > hdma::MAX_RUN) n = hdma::MAX_RUN;
+            fill_run(y, n, ta.reserve_lines(n), tb.reserve_lines(n), tc.reserve_lines(n), cs, sn);
+            y = static_cast<u8>(y + n);
+        }
+
+        ad.present();
+        b.present();
+        c.present();
+        scale_dirty = false;
+        angle_dirty = false;
+        return true;
+    }
+
+private:
+    // A, B and C entries for n lines from y0
+    void fill_run(u8 y0, u8 n, u8* pa, u8* pb, u8* pc, i16 cs, i16 sn) const {
+        const i16* sp = &scale[y0];
+        volatile u8* qa = pa;
+        volatile u8* qb = pb;
+        volatile u8* qc = pc;
+        u16 mc = math::detail::magnitude(cs);
+        u16 ms = math::detail::magnitude(sn);
+
+        // A coefficient of 0 or 1.0 (right angles and their neighbours)
+        // needs at most two multiplies per line
+        if (static_cast<u16>(mc - 1) >= 255 || static_cast<u16>(ms - 1) >= 255) {
+            for (u8 i = 0; i < n; i++) {
+                u16 s = static_cast<u16>(sp[i]);
+                i16 bv = detail::scale_mul(sn, s);
+                detail::put16(qa + i * 2, detail::scale_mul(cs, s));
+                detail::put16(qb + i * 2, bv);
+                detail::put16(qc + i * 2, static_cast<i16>(0 - bv));
+            }
+            return;
+        }
+
+        // Four products per line, each started before the stores that
+        // cover its latency: B and C of the previous line go out while
+        // this line's A products run (on the first line they land in the
+        // slot the second line overwrites)
+        u8 mcb = static_cast<u8>(mc);
+        u8 msb = static_cast<u8>(ms);
+        i16 bv = 0;
+        for (u8 i = 0; i < n; i++) {
+            u16 s = static_cast<u16>(sp[i]);
+            u8 sl = static_cast<u8>(s & 0xFF);
+            u8 sh = static_cast<u8>(s >> 8);
+
+            math::hw::mul_start(sl, mcb);
+            detail::put16(qb, bv);
+            u16 alo = math::hw::mul_result();
+            math::hw::mul_start(sh, mcb);
+            detail::put16(qc, static_cast<i16>(0 - bv));
+            u16 ahi = math::hw::mul_result();
+            math::hw::mul_start(sl, msb);
+            i16 av = detail::combine(alo, ahi, cs < 0);
+            qa[0] = static_cast<u8>(static_cast<u16>(av) & 0xFF);
+            u16 blo = math::hw::mul_result();
+            math::hw::mul_start(sh, msb);
+            qa[1] = static_cast<u8>(static_cast<u16>(av) >> 8);
+            qa += 2;
+            if (i != 0) {
+                qb += 2;
+                qc += 2;
+            }
+            u16 bhi = math::hw::mul_result();
+            bv = detail::combine(blo, bhi, sn < 0);
+        }
+        detail::put16(qb, bv);
+        detail::put16(qc, static_cast<i16>(0 - bv));
+    }
+
+public:
+    // Repoint the channels at the tables built by update()
+    // Call in VBlank; returns false if nothing was presented
+    bool commit() {
+        if (channels[0] == dma::NO_CHANNEL || !ad.pending) return false;
+        ad.commit(channels[0]);
+        b.commit(channels[1]);
+        c.commit(channels[2]);
+        dma::set_source(channels[3], reinterpret_cast<u32>(ad.active().bytes));
+        return true;
+    }
+};
+
+} // namespace snes::mode7
@@ -160,10 +160,7 @@ inline void set_obsel(u8 val) { hal::write8(reg::OBSEL::address, val); }
 inline void set_vmain(u8 val) { hal::write8(reg::VMAIN::address, val); }
 
 // Set VRAM address (16-bit word address)
-inline void set_vmaddr(u16 addr) {
-    hal::write8(reg::VMADDL::address, addr & 0xFF);
-    hal::write8(reg::VMADDH::address, addr >> 8);
-}
+inline void set_vmaddr(u16 addr) { reg::VMADD::write(addr); }
 
 // Set VRAM address (low/high bytes separately)
 inline void set_vmaddl(u8 lo) { hal::write8(reg::VMADDL::address, lo); }
@@ -173,6 +170,9 @@ inline void set_vmaddh(u8 hi) { hal::write8(reg::VMADDH::address, hi); }
 inline void set_vmdatal(u8 lo) { hal::write8(reg::VMDATAL::address, lo); }
 inline void set_vmdatah(u8 hi) { hal::write8(reg::VMDATAH::address, hi); }
 
+// Write a VRAM data word (low and high byte in one store)
+inline void set_vmdata(u16 val) { reg::VMDATA::write(val); }
+
 // ============================================================================
 // CGRAM (Palette) Access
 // ============================================================================
@@ -192,10 +192,7 @@ inline void set_oamaddl(u8 lo) { hal::write8(reg::OAMADDL::address, lo); }
 inline void set_oamaddh(u8 hi) { hal::write8(reg::OAMADDH::address, hi); }
 
 // Set OAM address (16-bit combined)
-inline void set_oamaddr(u16 addr) {
-    hal::write8(reg::OAMADDL::address, addr & 0xFF);
-    hal::write8(reg::OAMADDH::address, addr >> 8);
-}
+inline void set_oamaddr(u16 addr) { reg::OAMADD::write(addr); }
 
 // Write OAM data
 inline void write_oamdata(u8 val) { hal::write8(reg::OAMDATA::address, val); }
@@ -381,6 +378,50 @@ inline OAMEntry oam_low[128];
 inline u8 oam_high[32];
 #endif
 
+// Changed span of the shadow buffers since the last sprites_upload()
+// A span is empty when first > last. Sprite methods keep it up to date;
+// code that writes oam_low/oam_high directly must call sprites_mark_all()
+// or pass force_full to sprites_upload().
+struct OamDirty {
+    u8 low_first;   // First changed sprite (low table)
+    u8 low_last;    // Last changed sprite (low table)
+    u8 high_first;  // First changed high-table byte
+    u8 high_last;   // Last changed high-table byte
+
+    void clear() {
+        low_first = 0xFF;
+        low_last = 0;
+        high_first = 0xFF;
+        high_last = 0;
+    }
+
+    bool empty() const { return low_first > low_last && high_first > high_last; }
+
+    void mark_low(u8 id) {
+        if (id < low_first) low_first = id;
+        if (id > low_last) low_last = id;
+    }
+
+    void mark_high(u8 byte_idx) {
+        if (byte_idx < high_first) high_first = byte_idx;
+        if (byte_idx > high_last) high_last = byte_idx;
+    }
+
+    void mark_all() {
+        low_first = 0;
+        low_last = 127;
+        high_first = 0;
+        high_last = 31;
+    }
+};
+
+#ifdef SNES_TESTING
+extern OamDirty oam_dirty;
+#else
+// sprites_clear() (called by snes::init()) marks everything dirty
+inline OamDirty oam_dirty;
+#endif
+
 // ============================================================================
 // Sprite Class (OAM entry wrapper)
 // ============================================================================
@@ -400,6 +441,7 @@ public:
     void set_pos(i16 x, u8 y) {
         oam_low[m_id].x_low = static_cast<u8>(x & 0xFF);
         oam_low[m_id].y = y;
+        oam_dirty.mark_low(m_id);
 
         // Set X high bit in oam_high
         // Each byte holds 4 sprites: bits 0,2,4,6 = X high bits
@@ -408,9 +450,13 @@ public:
         u8 bit_pos = (m_id & 0x03) << 1;
         u8 x_high = (x & 0x100) ? 1 : 0;
 
-        oam_high[byte_idx] = static_cast<u8>(
+        u8 high = static_cast<u8>(
             (oam_high[byte_idx] & ~(0x01 << bit_pos)) | (x_high << bit_pos)
         );
+        if (high != oam_high[byte_idx]) {
+            oam_high[byte_idx] = high;
+            oam_dirty.mark_high(byte_idx);
+        }
     }
 
     // Set tile number (0-511)
@@ -426,6 +472,7 @@ public:
             (hflip ? 0x40 : 0) |             // Bit 6: H-flip
             (vflip ? 0x80 : 0)               // Bit 7: V-flip
         );
+        oam_dirty.mark_low(m_id);
     }
 
     // Set sprite priority (0-3, 0=lowest, 3=highest)
@@ -433,6 +480,7 @@ public:
         oam_low[m_id].attr = static_cast<u8>(
             (oam_low[m_id].attr & ~0x30) | ((prio & 0x03) << 4)
         );
+        oam_dirty.mark_low(m_id);
     }
 
     // Set sprite size (false=small, true=large)
@@ -448,11 +496,13 @@ public:
         } else {
             oam_high[byte_idx] &= static_cast<u8>(~(1 << bit_pos));
         }
+        oam_dirty.mark_high(byte_idx);
     }
 
     // Hide sprite by moving off-screen
     void hide() {
         oam_low[m_id].y = 240;  // Below visible area
+        oam_dirty.mark_low(m_id);
     }
 };
 
@@ -471,35 +521,162 @@ inline void sprites_clear() {
     for (int i = 0; i < 32; i++) {
         oam_high[i] = 0;
     }
+    oam_dirty.mark_all();
 }
 
-// Upload shadow OAM to hardware OAM via DMA
-// Should be called during VBlank
-inline void sprites_upload() {
-    // Set OAM address to 0
-    set_oamaddr(0);
+// Send the whole shadow OAM on the next sprites_upload()
+// (after writing oam_low/oam_high without the Sprite class)
+inline void sprites_mark_all() {
+    oam_dirty.mark_all();
+}
+
+namespace detail {
+// DMA part of the shadow OAM to hardware OAM
+// oam_addr: OAM word address (low table 0-255, high table 256-271)
+template<u8 Channel>
+inline void oam_dma(const void* src, u16 oam_addr, u16 size) {
+    set_oamaddr(oam_addr);
+
+    // A→B, 8-bit, auto-increment, to OAMDATA ($2104)
+    hal::write8(reg::DMA<Channel>::CTRL::address, 0x00);
+    hal::write8(reg::DMA<Channel>::DEST::address, 0x04);
 
-    // DMA channel 0: transfer oam_low (512 bytes) + oam_high (32 bytes)
-    // Total: 544 bytes
+    u32 addr = reinterpret_cast<u32>(src);
+    reg::DMA<Channel>::SRC::write(static_cast<u16>(addr & 0xFFFF));
+    hal::write8(reg::DMA<Channel>::SRCH::address, static_cast<u8>((addr >> 16) & 0xFF));
+    reg::DMA<Channel>::SIZE::write(size);
 
-    // Set DMA mode: A→B, 8-bit, auto-increment
-    set_dmap0(0x00);
+    start_dma(static_cast<u8>(1 << Channel));
+}
+} // namespace detail
 
-    // Set destination: OAMDATA ($2104)
-    set_bbad0(0x04);
+// Upload changed parts of shadow OAM to hardware OAM via DMA
+// Should be called during VBlank
+// Sends the dirty low-table sprites and the dirty high-table bytes (at most
+// two transfers); force_full sends all 544 bytes in one transfer.
+// Channel: GPDMA channel (must not be one claimed for HDMA, see dma.hpp)
+// Returns the number of bytes sent
+template<u8 Channel = 0>
+inline u16 sprites_upload(bool force_full = false) {
+    static_assert(Channel < 8, "DMA channel must be 0-7");
+
+    u16 sent = 0;
+
+    if (force_full) {
+        // oam_low (512 bytes) + oam_high (32 bytes), starting at OAM address 0
+        detail::oam_dma<Channel>(&oam_low[0], 0, 544);
+        oam_dirty.clear();
+        return 544;
+    }
 
-    // Set source address (oam_low)
-    u32 src = reinterpret_cast<u32>(&oam_low[0]);
-    set_a1t0l(static_cast<u8>(src & 0xFF));
-    set_a1t0h(static_cast<u8>((src >> 8) & 0xFF));
-    set_a1b0(static_cast<u8>((src >> 16) & 0xFF));
+    // Low table: 4 bytes (2 words) per sprite
+    if (oam_dirty.low_first <= oam_dirty.low_last) {
+        u8 first = oam_dirty.low_first;
+        u16 size = static_cast<u16>((oam_dirty.low_last - first + 1) * 4);
+        detail::oam_dma<Channel>(&oam_low[first], static_cast<u16>(first * 2), size);
+        sent = static_cast<u16>(sent + size);
+    }
 
-    // Set transfer size: 544 bytes (0x220)
-    set_das0l(0x20);
-    set_das0h(0x02);
+    // High table: OAM is word addressed, so widen to whole byte pairs
+    if (oam_dirty.high_first <= oam_dirty.high_last) {
+        u8 first = static_cast<u8>(oam_dirty.high_first & 0xFE);
+        u16 size = static_cast<u16>(((oam_dirty.high_last | 0x01) - first + 1));
+        detail::oam_dma<Channel>(&oam_high[first], static_cast<u16>(256 + (first >> 1)), size);
+        sent = static_cast<u16>(sent + size);
+    }
 
-    // Start DMA channel 0
-    start_dma(0x01);
+    oam_dirty.clear();
+    return sent;
 }
 
+// Make first_sprite the highest-priority sprite and the first one the PPU
+// evaluates for the 32-sprites-per-scanline limit (OAMADDH bit 7)
+// Write during VBlank, after the OAM upload (which rewrites OAMADD)
+inline void set_obj_priority_rotation(u8 first_sprite) {
+    reg::OAMADD::write(static_cast<u16>(0x8000 | ((first_sprite & 0x7F) << 1)));
+}
+
+// ============================================================================
+// Sprite Pool (per-frame OAM slot allocation)
+// ============================================================================
+
+// Hands out OAM slots from 0 upward each frame, so live sprites are packed at
+// the front. end_frame() hides only the slots that were live last frame and
+// not this one, instead of clearing all 128 entries.
+//
+// With more than 32 live sprites some scanlines can hit the hardware limit,
+// and the PPU drops the last sprites it evaluates. The pool rotates which
+// slot the PPU evaluates first every frame, so crowded lines flicker between
+// sprites instead of always losing the same ones. Rotation also changes which
+// sprite is drawn on top where they overlap.
+//
+//   pool.begin_frame();
+//   for (auto& e : enemies) {
+//       u8 slot = pool.alloc();
+//       if (slot == NO_SPRITE) break;
+//       Sprite s(slot);
+//       s.set_pos(e.x, e.y);
+//       s.set_tile(e.tile);
+//   }
+//   pool.end_frame();
+//   ...
+//   // in VBlank
+//   pool.upload();
+
+// Returned by SpritePool::alloc() when all 128 slots are in use
+constexpr u8 NO_SPRITE = 0xFF;
+
+// Plain data with no constructor: call reset() before first use
+struct SpritePool {
+    u8 count;       // Slots handed out this frame
+    u8 prev_count;  // Slots live after the last end_frame()
+    u8 first;       // Slot the PPU evaluates first
+    bool rotate;    // Rotate evaluation order when more than 32 are live
+
+    // Hide every sprite and start empty
+    void reset(bool rotate_priority = true) {
+        sprites_clear();
+        count = 0;
+        prev_count = 0;
+        first = 0;
+        rotate = rotate_priority;
+    }
+
+    // Start handing out slots from 0 again
+    void begin_frame() { count = 0; }
+
+    // Next free OAM slot, or NO_SPRITE
+    // The slot keeps last frame's tile, attributes and size; set what you need
+    u8 alloc() {
+        if (count >= 128) return NO_SPRITE;
+        return count++;
+    }
+
+    // Hide slots left over from last frame and advance the rotation
+    void end_frame() {
+        for (u8 i = count; i < prev_count; i++) {
+            oam_low[i].y = 240;  // Off-screen
+            oam_dirty.mark_low(i);
+        }
+        prev_count = count;
+
+        if (!rotate || count <= 32) {
+            first = 0;
+        } else {
+            // Advance by a full scanline's worth of sprites
+            first = static_cast<u8>(first + 32);
+            while (first >= count) first = static_cast<u8>(first - count);
+        }
+    }
+
+    // Upload shadow OAM and apply this frame's rotation
+    // Should be called during VBlank
+    template<u8 Channel = 0>
+    u16 upload(bool force_full = false) {
+        u16 sent = sprites_upload<Channel>(force_full);
+        set_obj_priority_rotation(first);
+        return sent;
+    }
+};
+
 } // namespace snes::ppu
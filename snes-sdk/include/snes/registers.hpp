@@ -39,12 +39,14 @@ struct RWReg {
     static constexpr u32 address = Addr;
 };
 
-// 16-bit write-only register (low byte first, auto-increment)
+// 16-bit write-only register pair (low at AddrLo, high at AddrLo + 1)
+// Written with a single 16-bit store, which the CPU performs low byte first.
+// Only for adjacent pairs; write-twice registers (BGnHOFS, M7A...) need
+// two byte writes to the same address instead.
 template<u32 AddrLo>
 struct WReg16 {
     static void write(u16 val) {
-        hal::write8(AddrLo, static_cast<u8>(val & 0xFF));
-        hal::write8(AddrLo + 1, static_cast<u8>(val >> 8));
+        hal::write16(AddrLo, val);
     }
 
     static constexpr u32 address = AddrLo;
@@ -70,6 +72,7 @@ namespace reg {
     using OAMADDL  = WReg<0x2102>;   // OAM address low
     using OAMADDH  = WReg<0x2103>;   // OAM address high
     using OAMDATA  = WReg<0x2104>;   // OAM data write
+    using OAMADD   = WReg16<0x2102>; // OAM address (OAMADDL/OAMADDH pair)
 
     // Background Mode and Character Size
     using BGMODE   = WReg<0x2105>;   // BG mode and character size
@@ -101,6 +104,8 @@ namespace reg {
     using VMADDH   = WReg<0x2117>;   // VRAM address high
     using VMDATAL  = WReg<0x2118>;   // VRAM data write low
     using VMDATAH  = WReg<0x2119>;   // VRAM data write high
+    using VMADD    = WReg16<0x2116>; // VRAM address (VMADDL/VMADDH pair)
+    using VMDATA   = WReg16<0x2118>; // VRAM data write (VMDATAL/VMDATAH pair)
     using RDVRAML  = RReg<0x2139>;   // VRAM data read low
     using RDVRAMH  = RReg<0x213A>;   // VRAM data read high
 
@@ -164,6 +169,7 @@ namespace reg {
     using WRDIVL   = WReg<0x4204>;   // Dividend low
     using WRDIVH   = WReg<0x4205>;   // Dividend high
     using WRDIVB   = WReg<0x4206>;   // Divisor
+    using WRDIV    = WReg16<0x4204>; // Dividend (WRDIVL/WRDIVH pair)
     using HTIMEL   = WReg<0x4207>;   // H-count timer low
     using HTIMEH   = WReg<0x4208>;   // H-count timer high
     using VTIMEL   = WReg<0x4209>;   // V-count timer low
@@ -207,10 +213,13 @@ namespace reg {
         using SRCH   = WReg<base + 4>;   // Source address bank
         using SIZEL  = WReg<base + 5>;   // Transfer size low
         using SIZEH  = WReg<base + 6>;   // Transfer size high
+        using SRC    = WReg16<base + 2>; // Source address low/mid pair (A1TnL/H)
+        using SIZE   = WReg16<base + 5>; // Transfer size pair (DASnL/H)
         using HDMA   = WReg<base + 7>;   // HDMA indirect bank
         using ADDRL  = WReg<base + 8>;   // HDMA table address low
         using ADDRH  = WReg<base + 9>;   // HDMA table address high
         using LINES  = WReg<base + 10>;  // HDMA line counter
+        using ADDR   = WReg16<base + 8>; // HDMA table address pair
     };
 
     // APU Communication Ports
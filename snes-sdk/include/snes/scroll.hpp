@@ -0,0 +1,292 @@
+#pragma once
+
+// SNES Scroll API - Streaming tilemap scroller for maps larger than VRAM
+//
+// The world map (row-major tilemap entries, any size up to 65535 tiles a
+// side) stays in WRAM or ROM. VRAM holds a 64x32 hardware tilemap (BGnSC
+// size 1) used as a ring buffer: world tile (c, r) lives at hardware tile
+// (c & 63, r & 31), so the BG scroll registers can take the camera position
+// directly.
+//
+// The resident window is 64 columns (16 left of the camera, 48 from it) by
+// 32 rows (2 above, 30 from it); the screen shows 33x29 tiles. Each time the
+// camera crosses a tile boundary only the newly exposed column (64 bytes,
+// one DMA with VMAIN increment-by-32) or row (128 bytes) is sent.
+//
+// A WRAM shadow of the hardware tilemap is kept in VRAM order. When the
+// camera jumps too far for edge streaming, scroll_to() regathers the whole
+// shadow during active display and queues it (4KB) on dma::g_queue, whose
+// per-frame budget spreads it over as many VBlanks as needed. Edges sent in
+// the meantime are also written to the shadow, so the queued remainder never
+// overwrites them with stale tiles. Full reloads therefore need the global
+// queue flushed every frame (dma::install_queue()), and commit() must then
+// run from a VBlank hook of its own so the queue's NMI flush cannot land in
+// the middle of it.
+//
+//   scroller.init(bg_index, vram_tilemap_addr, level_map, 512, 64);
+//   scroller.load(0, 0);              // forced blank: fill the window
+//   loop:
+//       scroller.scroll_to(cam_x, cam_y);  // gathers new edges into WRAM
+//       vblank hook: scroller.commit();     // DMA + scroll registers
+
+#include "types.hpp"
+#include "hal.hpp"
+#include "registers.hpp"
+#include "dma.hpp"
+
+namespace snes::scroll {
+
+constexpr u8 MAP_COLS = 64;  // Hardware tilemap width (two 32x32 screens)
+constexpr u8 MAP_ROWS = 32;  // Hardware tilemap height
+constexpr u8 MARGIN_COLS = 16;  // Resident columns left of the camera
+constexpr u8 MARGIN_ROWS = 2;   // Resident rows above the camera
+
+// Edges buffered per frame; faster scrolling falls back to a full reload
+constexpr u8 MAX_COLUMNS = 2;
+constexpr u8 MAX_ROWS = 2;
+
+// Plain data with no constructor: call init() before first use
+struct Scroller {
+    const u16* world;    // World tilemap, row-major
+    u16 world_cols;
+    u16 world_rows;
+    u16 vram_base;       // Word address of the 64x32 hardware tilemap (2K words)
+    u8 bg;               // Background 1-3
+    u16 cam_x;           // Camera position in pixels
+    u16 cam_y;
+    i16 tile_x;          // Camera position in tiles
+    i16 tile_y;
+
+    // Hardware tilemap in VRAM order: two 32x32 screens, row-major
+    // A resident row is contiguous in each screen, so rows are sent from here
+    u16 shadow[MAP_COLS * MAP_ROWS];
+
+    // Pending edges, gathered in hardware order
+    u16 col_buf[MAX_COLUMNS][MAP_ROWS];
+    u8 col_hw[MAX_COLUMNS];      // Hardware column of each buffer
+    u8 col_count;
+    u8 row_hw[MAX_ROWS];         // Hardware row of each pending row
+    u8 row_count;
+    bool full_reload;            // Window must be regathered and queued
+    bool scroll_dirty;           // Scroll registers need writing
+
+    // bg_index: background 1-3 (its BGnSC must select a 64x32 map at vram_addr)
+    void init(u8 bg_index, u16 vram_addr, const u16* map, u16 cols, u16 rows) {
+        bg = bg_index;
+        vram_base = vram_addr;
+        world = map;
+        world_cols = cols;
+        world_rows = rows;
+        cam_x = 0;
+        cam_y = 0;
+        tile_x = 0;
+        tile_y = 0;
+        col_count = 0;
+        row_count = 0;
+        full_reload = true;
+        scroll_dirty = true;
+    }
+
+    // World tile, or 0 outside the map
+    u16 tile_at(i16 col, i16 row) const {
+        if (col < 0 || row < 0 || static_cast<u16>(col) >= world_cols ||
+            static_cast<u16>(row) >= world_rows) {
+            return 0;
+        }
+        return world[static_cast<u32>(row) * world_cols + static_cast<u16>(col)];
+    }
+
+    // Move the camera (pixels) and gather any newly exposed edges
+    // Run during active display; commit() sends them in VBlank
+    // A full reload is gathered here and queued on dma::g_queue; if the
+    // queue is full it is retried on the next call
+    void scroll_to(u16 x, u16 y) {
+        cam_x = x;
+        cam_y = y;
+        scroll_dirty = true;
+        if (full_reload) {
+            tile_x = static_cast<i16>(x >> 3);
+            tile_y = static_cast<i16>(y >> 3);
+            gather_window();
+            if (dma::queue_vram(shadow, vram_base, sizeof(shadow))) {
+                full_reload = false;
+            }
+            return;
+        }
+
+        i16 new_tx = static_cast<i16>(x >> 3);
+        i16 new_ty = static_cast<i16>(y >> 3);
+        i16 cols[MAX_COLUMNS];
+        i16 rows[MAX_ROWS];
+        u8 ncols = col_count;
+        u8 nrows = row_count;
+
+        // Work out which world columns/rows enter the resident window
+        while (tile_x != new_tx) {
+            i16 col;
+            if (tile_x < new_tx) {
+                tile_x++;
+                col = static_cast<i16>(tile_x - MARGIN_COLS + MAP_COLS - 1);
+            } else {
+                tile_x--;
+                col = static_cast<i16>(tile_x - MARGIN_COLS);
+            }
+            if (ncols == MAX_COLUMNS) {
+                request_full_reload(x, y);
+                return;
+            }
+            cols[ncols++] = col;
+        }
+        while (tile_y != new_ty) {
+            i16 row;
+            if (tile_y < new_ty) {
+                tile_y++;
+                row = static_cast<i16>(tile_y - MARGIN_ROWS + MAP_ROWS - 1);
+            } else {
+                tile_y--;
+                row = static_cast<i16>(tile_y - MARGIN_ROWS);
+            }
+            if (nrows == MAX_ROWS) {
+                request_full_reload(x, y);
+                return;
+            }
+            rows[nrows++] = row;
+        }
+
+        // Gather against the final window so diagonal moves stay consistent
+        for (u8 i = col_count; i < ncols; i++) gather_column(i, cols[i]);
+        for (u8 i = row_count; i < nrows; i++) gather_row(i, rows[i]);
+        col_count = ncols;
+        row_count = nrows;
+    }
+
+    // Fill the whole resident window around (x, y) immediately
+    // Only call during forced blank (one 4KB DMA)
+    template<u8 Channel = 0>
+    void load(u16 x, u16 y) {
+        cam_x = x;
+        cam_y = y;
+        tile_x = static_cast<i16>(x >> 3);
+        tile_y = static_cast<i16>(y >> 3);
+        gather_window();
+        dma::transfer_to_vram<Channel>(shadow, vram_base, sizeof(shadow));
+        full_reload = false;
+        col_count = 0;
+        row_count = 0;
+        write_scroll();
+    }
+
+    // Send gathered edges and update the scroll registers
+    // Call in VBlank; returns the number of bytes transferred
+    // (full reloads are sent by the queue and not counted here)
+    template<u8 Channel = 0>
+    u16 commit() {
+        u16 sent = 0;
+
+        for (u8 i = 0; i < col_count; i++) {
+            u8 hw = col_hw[i];
+            u16 addr = static_cast<u16>(vram_base + (hw >> 5) * 0x400 + (hw & 31));
+            dma::transfer_to_vram_column<Channel>(col_buf[i], addr, MAP_ROWS * 2);
+            sent = static_cast<u16>(sent + MAP_ROWS * 2);
+        }
+        for (u8 i = 0; i < row_count; i++) {
+            u16 offset = static_cast<u16>(row_hw[i] * 32);
+            u16 addr = static_cast<u16>(vram_base + offset);
+            dma::transfer_to_vram<Channel>(&shadow[offset], addr, 64);
+            dma::transfer_to_vram<Channel>(&shadow[offset + 0x400],
+                                           static_cast<u16>(addr + 0x400), 64);
+            sent = static_cast<u16>(sent + 128);
+        }
+        col_count = 0;
+        row_count = 0;
+
+        if (scroll_dirty) write_scroll();
+        return sent;
+    }
+
+private:
+    // Drop pending edges and regather the window around (x, y) now
+    void request_full_reload(u16 x, u16 y) {
+        full_reload = true;
+        col_count = 0;
+        row_count = 0;
+        scroll_to(x, y);
+    }
+
+    // First entry of world row `row`, or nullptr outside the map
+    const u16* row_ptr(i16 row) const {
+        if (row < 0 || static_cast<u16>(row) >= world_rows) return nullptr;
+        return world + static_cast<u32>(row) * world_cols;
+    }
+
+    // Copy the resident columns of one world row into its shadow row
+    // line: the row's first entry, or nullptr for a row outside the map
+    void fill_row(i16 row, const u16* line) {
+        u16* dst = &shadow[(row & (MAP_ROWS - 1)) * 32];
+        i16 col = static_cast<i16>(tile_x - MARGIN_COLS);
+        for (u8 i = 0; i < MAP_COLS; i++, col++) {
+            u16 tile = 0;
+            if (line && col >= 0 && static_cast<u16>(col) < world_cols) tile = line[col];
+            u8 hw = static_cast<u8>(col & (MAP_COLS - 1));
+            dst[(hw >> 5) * 0x400 + (hw & 31)] = tile;
+        }
+    }
+
+    // Column `col` of the world over the resident rows, by hardware row
+    // Steps a pointer down the world column instead of indexing each tile
+    void gather_column(u8 slot, i16 col) {
+        u8 hw_col = static_cast<u8>(col & (MAP_COLS - 1));
+        u16* buf = col_buf[slot];
+        u16* dst = &shadow[(hw_col >> 5) * 0x400 + (hw_col & 31)];
+        bool in_map = col >= 0 && static_cast<u16>(col) < world_cols;
+        const u16* src = nullptr;
+        i16 row = static_cast<i16>(tile_y - MARGIN_ROWS);
+        for (u8 i = 0; i < MAP_ROWS; i++, row++) {
+            u16 tile = 0;
+            if (in_map && row >= 0 && static_cast<u16>(row) < world_rows) {
+                // The rows inside the map are contiguous: one multiply per column
+                if (!src) src = row_ptr(row) + col;
+                tile = *src;
+                src += world_cols;
+            }
+            u8 hw_row = static_cast<u8>(row & (MAP_ROWS - 1));
+            buf[hw_row] = tile;
+            dst[hw_row * 32] = tile;
+        }
+        col_hw[slot] = hw_col;
+    }
+
+    // Row `row` of the world over the resident columns, into the shadow
+    void gather_row(u8 slot, i16 row) {
+        fill_row(row, row_ptr(row));
+        row_hw[slot] = static_cast<u8>(row & (MAP_ROWS - 1));
+    }
+
+    // Every resident row, stepping the world row pointer between rows
+    void gather_window() {
+        i16 row = static_cast<i16>(tile_y - MARGIN_ROWS);
+        const u16* line = nullptr;
+        for (u8 i = 0; i < MAP_ROWS; i++, row++) {
+            if (row < 0 || static_cast<u16>(row) >= world_rows) {
+                line = nullptr;
+            } else if (line) {
+                line += world_cols;
+            } else {
+                line = row_ptr(row);
+            }
+            fill_row(row, line);
+        }
+    }
+
+    // BGnHOFS/BGnVOFS (write twice); the ring layout makes them the camera
+    void write_scroll() {
+        u32 hofs = reg::BG1HOFS::address + (bg - 1) * 2;
+        hal::write8(hofs, static_cast<u8>(cam_x & 0xFF));
+        hal::write8(hofs, static_cast<u8>((cam_x >> 8) & 0xFF));
+        hal::write8(hofs + 1, static_cast<u8>(cam_y & 0xFF));
+        hal::write8(hofs + 1, static_cast<u8>((cam_y >> 8) & 0xFF));
+        scroll_dirty = false;
+    }
+};
+
+} // namespace snes::scroll
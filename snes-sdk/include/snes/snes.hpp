@@ -12,6 +12,13 @@
 #include "text.hpp"
 #include "math.hpp"
 #include "dma.hpp"
+#include "hdma.hpp"
+#include "mode7.hpp"
+#include "vram.hpp"
+#include "scroll.hpp"
+#include "entity.hpp"
+#include "collision.hpp"
+#include "vblank.hpp"
 
 namespace snes {
 
@@ -27,7 +34,10 @@ inline void init() {
     // Clear sprites
     ppu::sprites_clear();
 
-    // Enable joypad auto-read
+    // Clear the joypad latch and the DMA channel allocator (BSS is not
+    // zeroed) and enable auto-read
+    input::reset_latch();
+    dma::g_channels.reset();
     input::enable_joypad();
 
     // Set default mode 1
@@ -2,6 +2,15 @@
 
 #include "types.hpp"
 #include "ppu.hpp"
+#include "dma.hpp"
+
+// Text is drawn into a WRAM shadow of the tilemap, so printing is safe at
+// any time. flush() copies the changed rows to VRAM by DMA and must run in
+// VBlank or forced blank; install_flush() has the NMI handler do it.
+// Each flush stops at a byte budget and leaves the remaining rows dirty for
+// the next frame. The default budget is what dma::VBLANK_DMA_BUDGET leaves
+// after the OAM upload and dma::g_queue's default budget.
+// Transfers use the first GPDMA channel from dma::g_channels.
 
 namespace snes {
 namespace text {
@@ -10,6 +19,15 @@ namespace text {
 constexpr u8 SCREEN_COLS = 32;  // 256 pixels / 8 pixels per tile
 constexpr u8 SCREEN_ROWS = 28;  // 224 pixels / 8 pixels per tile (excluding overscan)
 
+// Tilemap bytes per row, and for the whole screen
+constexpr u16 ROW_BYTES = SCREEN_COLS * 2;
+constexpr u16 SCREEN_BYTES = SCREEN_ROWS * ROW_BYTES;
+
+// Default per-flush budget in bytes: a clear plus three rows, or every row
+constexpr u16 DEFAULT_FLUSH_BUDGET =
+    dma::VBLANK_DMA_BUDGET - dma::OAM_UPLOAD_BYTES - dma::DEFAULT_FRAME_BUDGET;
+static_assert(DEFAULT_FLUSH_BUDGET >= SCREEN_BYTES, "flush budget must fit a clear");
+
 // Tab alignment mask - rounds x position down to multiple of 4
 // Tab stops are at columns 0, 4, 8, 12, 16, 20, 24, 28
 constexpr u8 TAB_ALIGN_MASK = 0xFC;  // ~0x03, clears lower 2 bits
@@ -31,15 +49,32 @@ struct TextConfig {
 extern Cursor g_cursor;
 extern TextConfig g_config;
 
+// Shadow tilemap (row-major, SCREEN_COLS entries per row)
+extern u16 g_shadow[SCREEN_ROWS * SCREEN_COLS];
+
+// Bit per shadow row changed since the last flush()
+extern volatile u32 g_dirty_rows;
+
+// clear() was called: flush() fills the whole tilemap first
+extern volatile bool g_clear_pending;
+
+// Set while putchar() or clear() updates the state above; the NMI flush
+// skips that frame rather than race the multi-byte read-modify-write
+extern volatile bool g_updating;
+
 // Initialize text system
 // tilemap_addr: VRAM word address for text tilemap
 // font_tile_base: First tile number where font starts (maps to ASCII 32)
+// Call clear() afterwards to blank the screen
 inline void init(u16 tilemap_addr, u16 font_tile_base, u8 palette = 0) {
     g_config.tilemap_addr = tilemap_addr;
     g_config.font_tile_base = font_tile_base;
     g_config.palette = palette;
     g_cursor.x = 0;
     g_cursor.y = 0;
+    g_dirty_rows = 0;
+    g_clear_pending = false;
+    g_updating = false;
 }
 
 // Set cursor position
@@ -64,14 +99,44 @@ void puts(const char* str);
 void println(const char* str);
 
 // Clear the text screen (fill with spaces)
+// The VRAM tilemap is filled by a single DMA on the next flush()
 void clear();
 
+// Copy changed rows of the shadow tilemap to VRAM
+// Runs of adjacent dirty rows go out as one DMA. A pending clear always
+// goes first (SCREEN_BYTES, even above budget); rows that no longer fit
+// stay dirty for the next flush
+// Call during VBlank or forced blank; returns the number of bytes sent
+u16 flush(u16 budget = DEFAULT_FLUSH_BUDGET);
+
+// Have the NMI handler call flush(budget) every frame
+// Returns false if no VBlank hook slot is free
+// While installed, main code must not start DMA or write VMAIN/VMADD with
+// NMI enabled; the same rule as dma::install_queue() applies
+bool install_flush(u16 budget = DEFAULT_FLUSH_BUDGET);
+
+// Stop flushing from the NMI handler
+void uninstall_flush();
+
+// Decimal digits of value, most significant first, always 5 characters
+// ("00042"); returns the number of significant digits (at least 1)
+// Uses no division, so it is cheap enough for per-frame HUD redraws
+u8 format_u16(u16 value, char* digits);
+
 // Print an unsigned 16-bit integer
 void print_u16(u16 value);
 
+// Print right-aligned in width columns, padded with pad ('0' for zero fill)
+// Wider values are printed in full
+void print_u16(u16 value, u8 width, char pad = ' ');
+
 // Print a signed 16-bit integer
 void print_i16(i16 value);
 
+// Print right-aligned in width columns (the sign counts toward width)
+// Zero fill goes between the sign and the digits: "-0042"
+void print_i16(i16 value, u8 width, char pad = ' ');
+
 // Print a hex value (4 digits)
 void print_hex(u16 value);
 
@@ -12,86 +12,331 @@ using i8  = signed char;
 using i16 = signed short;
 using i32 = signed long;
 
-// 8.8 fixed point number
-struct Fixed8 {
-    i16 raw;
+// ============================================================================
+// Fixed Point
+// ============================================================================
+
+// Storage properties for Fixed (i8, i16 and i32 are supported)
+// Wide holds a full product, so multiply and divide never overflow inside.
+// i32 formats only use it for constants and conversions: their arithmetic
+// goes through FixedLong rather than the compiler's 64-bit routines.
+// Int is the to_int() type.
+template<typename S> struct FixedStorage;
+
+template<> struct FixedStorage<i8> {
+    using Wide = i16;
+    using Unsigned = u8;
+    using Int = int;
+    static constexpr u8 bits = 8;
+    static constexpr i8 min = -128;
+    static constexpr i8 max = 127;
+};
 
-    constexpr Fixed8() : raw(0) {}
-    constexpr explicit Fixed8(i16 r) : raw(r) {}
+template<> struct FixedStorage<i16> {
+    using Wide = i32;
+    using Unsigned = u16;
+    using Int = int;
+    static constexpr u8 bits = 16;
+    static constexpr i16 min = -32768;
+    static constexpr i16 max = 32767;
+};
+
+template<> struct FixedStorage<i32> {
+    using Wide = long long;
+    using Unsigned = u32;
+    using Int = i32;
+    static constexpr u8 bits = 32;
+    static constexpr i32 min = -2147483647L - 1;
+    static constexpr i32 max = 2147483647L;
+};
 
-    constexpr static Fixed8 from_int(int v) {
-        return Fixed8(static_cast<i16>(v << 8));
+// Signed 64-bit intermediate of i32 formats as two 32-bit words
+// A product is four 16x16->32 multiplies and a quotient a 32-bit
+// shift-and-subtract loop, where long long would call the generic 64x64
+// multiply and 64/64 divide. Words are masked because u32 is wider than
+// 32 bits on the host.
+struct FixedLong {
+    static constexpr u32 MASK = 0xFFFFFFFFUL;
+    static constexpr u32 SIGN = 0x80000000UL;
+
+    u32 hi;
+    u32 lo;
+
+    // Sign-extend a 32-bit word
+    constexpr static i32 wrap(u32 v) {
+        return (v & SIGN) ? static_cast<i32>(-static_cast<i32>(~v & MASK) - 1) : static_cast<i32>(v);
     }
 
-    constexpr static Fixed8 from_float(float v) {
-        return Fixed8(static_cast<i16>(v * 256.0f));
+    constexpr static u32 word(i32 v) { return static_cast<u32>(v) & MASK; }
+
+    // Full signed product: unsigned product of the words, then subtract
+    // the other operand from the high word for each negative one
+    constexpr static FixedLong product(i32 a, i32 b) {
+        u32 ua = word(a);
+        u32 ub = word(b);
+        u32 al = ua & 0xFFFF;
+        u32 ah = ua >> 16;
+        u32 bl = ub & 0xFFFF;
+        u32 bh = ub >> 16;
+        u32 ll = al * bl;
+        u32 lh = al * bh;
+        u32 hl = ah * bl;
+        u32 mid = (ll >> 16) + (lh & 0xFFFF) + (hl & 0xFFFF);
+        FixedLong r{ah * bh + (lh >> 16) + (hl >> 16) + (mid >> 16),
+                    ((mid & 0xFFFF) << 16) | (ll & 0xFFFF)};
+        if (a < 0) r.hi -= ub;
+        if (b < 0) r.hi -= ua;
+        r.hi &= MASK;
+        return r;
     }
 
-    constexpr int to_int() const { return raw >> 8; }
+    // Arithmetic shift right by n (0-31)
+    constexpr FixedLong shr(u8 n) const {
+        if (n == 0) return *this;
+        u32 fill = (hi & SIGN) ? (MASK << (32 - n)) & MASK : 0;
+        return FixedLong{(hi >> n) | fill, ((lo >> n) | (hi << (32 - n))) & MASK};
+    }
 
-    // Fractional part (0-255)
-    constexpr u8 frac() const { return static_cast<u8>(raw & 0xFF); }
+    // Value fits in 32 bits
+    constexpr bool fits() const { return hi == ((lo & SIGN) ? MASK : 0); }
+
+    constexpr bool negative() const { return (hi & SIGN) != 0; }
+
+    constexpr i32 low() const { return wrap(lo); }
+
+    // (a << n) / b, truncated toward zero and wrapped to 32 bits (n 0-31)
+    constexpr static i32 quotient(i32 a, u8 n, i32 b) {
+        u32 ma = a < 0 ? (0 - word(a)) & MASK : word(a);
+        u32 mb = b < 0 ? (0 - word(b)) & MASK : word(b);
+
+        // The remainder stays below mb <= 2^31, so shifting it left fits
+        u32 q = 0;
+        u32 r = 0;
+        for (u8 i = 0; i < 32 + n; i++) {
+            u32 bit = i < 32 ? (ma >> (31 - i)) & 1 : 0;
+            r = (r << 1) | bit;
+            q = (q << 1) & MASK;
+            if (r >= mb) {
+                r -= mb;
+                q |= 1;
+            }
+        }
+        if ((a < 0) != (b < 0)) q = (0 - q) & MASK;
+        return wrap(q);
+    }
+};
 
-    constexpr Fixed8 operator+(Fixed8 o) const {
-        return Fixed8(static_cast<i16>(raw + o.raw));
+// Return type of Fixed::frac(): u8 when the fraction fits in a byte
+template<bool Byte, typename Wider> struct FixedFrac { using Type = Wider; };
+template<typename Wider> struct FixedFrac<true, Wider> { using Type = u8; };
+
+// Signed fixed point: IntBits (including sign) . FracBits in Storage
+//
+// Pick the narrowest format that holds each value: an i16 format costs one
+// 16-bit op for +/-. Multiply and divide use the narrowest full product:
+// 8x8->16 for i8 formats, 16x16->32 for i16 formats, and FixedLong's
+// 32x32->64 for i32 formats. Cheaper lowerings are explicit:
+//   x * 3, x / 3     integer scale, no shift or wide math
+//   x << 1, x >> 2   power-of-two scale
+//   math::hw::mul()  CPU hardware multiplier (8- and 16-bit formats)
+// Plain operators wrap on overflow; the *_sat variants clamp.
+// Formats convert with fixed_cast (wraps) or saturate_cast (clamps).
+template<u8 IntBits, u8 FracBits, typename Storage = i16>
+struct Fixed {
+    using Traits = FixedStorage<Storage>;
+    using StorageType = Storage;
+    using Wide = typename Traits::Wide;
+    using FracType = typename FixedFrac<(FracBits <= 8), typename Traits::Unsigned>::Type;
+
+    static_assert(IntBits + FracBits == Traits::bits, "Fixed bits must fill the storage type");
+    static_assert(IntBits >= 1, "Fixed needs a sign bit");
+
+    static constexpr u8 int_bits = IntBits;
+    static constexpr u8 frac_bits = FracBits;
+    static constexpr Wide one = static_cast<Wide>(1) << FracBits;  // Raw value of 1.0
+
+    Storage raw;
+
+    constexpr Fixed() : raw(0) {}
+    constexpr explicit Fixed(Storage r) : raw(r) {}
+
+    // Shifts the unsigned bit pattern, like operator<<
+    constexpr static Fixed from_int(int v) {
+        using U = typename Traits::Unsigned;
+        return Fixed(static_cast<Storage>(static_cast<U>(static_cast<U>(v) << FracBits)));
     }
 
-    constexpr Fixed8 operator-(Fixed8 o) const {
-        return Fixed8(static_cast<i16>(raw - o.raw));
+    constexpr static Fixed from_float(float v) {
+        return Fixed(static_cast<Storage>(v * static_cast<float>(one)));
     }
 
-    constexpr Fixed8 operator-() const {
-        return Fixed8(static_cast<i16>(-raw));
+    // Largest and smallest representable values
+    constexpr static Fixed max() { return Fixed(Traits::max); }
+    constexpr static Fixed min() { return Fixed(Traits::min); }
+
+    // Integer part, rounded toward negative infinity
+    // An int, as before Fixed was a template; i32 formats return i32
+    constexpr typename Traits::Int to_int() const {
+        return static_cast<typename Traits::Int>(raw >> FracBits);
     }
 
-    Fixed8 operator*(Fixed8 o) const {
-        return Fixed8(static_cast<i16>((static_cast<i32>(raw) * o.raw) >> 8));
+    // Fractional part (0 to one - 1); a u8 for formats with up to 8 fraction bits
+    constexpr FracType frac() const {
+        return static_cast<FracType>(raw & (one - 1));
     }
 
-    Fixed8 operator/(Fixed8 o) const {
-        return Fixed8(static_cast<i16>((static_cast<i32>(raw) << 8) / o.raw));
+    constexpr Fixed operator+(Fixed o) const {
+        return Fixed(static_cast<Storage>(raw + o.raw));
     }
 
-    constexpr Fixed8& operator+=(Fixed8 o) {
-        raw = static_cast<i16>(raw + o.raw);
-        return *this;
+    constexpr Fixed operator-(Fixed o) const {
+        return Fixed(static_cast<Storage>(raw - o.raw));
     }
 
-    constexpr Fixed8& operator-=(Fixed8 o) {
-        raw = static_cast<i16>(raw - o.raw);
-        return *this;
+    constexpr Fixed operator-() const {
+        return Fixed(static_cast<Storage>(-raw));
     }
 
-    constexpr bool operator==(Fixed8 o) const { return raw == o.raw; }
-    constexpr bool operator!=(Fixed8 o) const { return raw != o.raw; }
-    constexpr bool operator<(Fixed8 o) const { return raw < o.raw; }
-    constexpr bool operator<=(Fixed8 o) const { return raw <= o.raw; }
-    constexpr bool operator>(Fixed8 o) const { return raw > o.raw; }
-    constexpr bool operator>=(Fixed8 o) const { return raw >= o.raw; }
-};
+    constexpr Fixed operator*(Fixed o) const {
+        if constexpr (Traits::bits == 32) {
+            return Fixed(FixedLong::product(raw, o.raw).shr(FracBits).low());
+        } else {
+            return Fixed(static_cast<Storage>((static_cast<Wide>(raw) * static_cast<Wide>(o.raw)) >> FracBits));
+        }
+    }
 
-// 4.12 fixed point for higher precision (useful for angles/trig)
-struct Fixed12 {
-    i16 raw;
+    constexpr Fixed operator/(Fixed o) const {
+        if constexpr (Traits::bits == 32) {
+            return Fixed(FixedLong::quotient(raw, FracBits, o.raw));
+        } else {
+            return Fixed(static_cast<Storage>((static_cast<Wide>(raw) * one) / o.raw));
+        }
+    }
+
+    // Integer scale: no shift and no wide intermediate
+    constexpr Fixed operator*(Storage n) const {
+        return Fixed(static_cast<Storage>(raw * n));
+    }
+
+    constexpr Fixed operator/(Storage n) const {
+        return Fixed(static_cast<Storage>(raw / n));
+    }
+
+    // Power-of-two scale (>> rounds toward negative infinity)
+    // << shifts the unsigned bit pattern, since shifting a negative value is
+    // undefined; the result wraps like the other plain operators
+    constexpr Fixed operator<<(u8 n) const {
+        return Fixed(static_cast<Storage>(static_cast<typename Traits::Unsigned>(raw) << n));
+    }
+
+    constexpr Fixed operator>>(u8 n) const {
+        return Fixed(static_cast<Storage>(raw >> n));
+    }
+
+    // Multiply by another format; the result keeps this format
+    template<u8 I2, u8 F2, typename S2>
+    constexpr Fixed mul(Fixed<I2, F2, S2> o) const {
+        if constexpr (Traits::bits == 32 || FixedStorage<S2>::bits == 32) {
+            return Fixed(static_cast<Storage>(FixedLong::product(raw, o.raw).shr(F2).low()));
+        } else {
+            using W = decltype(Wide() + typename Fixed<I2, F2, S2>::Wide());
+            return Fixed(static_cast<Storage>((static_cast<W>(raw) * static_cast<W>(o.raw)) >> F2));
+        }
+    }
 
-    constexpr Fixed12() : raw(0) {}
-    constexpr explicit Fixed12(i16 r) : raw(r) {}
+    // Saturating arithmetic
+    // i32 formats detect overflow from the signs instead of widening
+    constexpr Fixed add_sat(Fixed o) const {
+        if constexpr (Traits::bits == 32) {
+            i32 r = FixedLong::wrap((FixedLong::word(raw) + FixedLong::word(o.raw)) & FixedLong::MASK);
+            if (raw >= 0 && o.raw >= 0 && r < 0) return max();
+            if (raw < 0 && o.raw < 0 && r >= 0) return min();
+            return Fixed(r);
+        } else {
+            return saturate(static_cast<Wide>(raw) + o.raw);
+        }
+    }
 
-    constexpr static Fixed12 from_int(int v) {
-        return Fixed12(static_cast<i16>(v << 12));
+    constexpr Fixed sub_sat(Fixed o) const {
+        if constexpr (Traits::bits == 32) {
+            i32 r = FixedLong::wrap((FixedLong::word(raw) - FixedLong::word(o.raw)) & FixedLong::MASK);
+            if (raw >= 0 && o.raw < 0 && r < 0) return max();
+            if (raw < 0 && o.raw >= 0 && r >= 0) return min();
+            return Fixed(r);
+        } else {
+            return saturate(static_cast<Wide>(raw) - o.raw);
+        }
     }
 
-    constexpr int to_int() const { return raw >> 12; }
+    constexpr Fixed mul_sat(Fixed o) const {
+        if constexpr (Traits::bits == 32) {
+            FixedLong p = FixedLong::product(raw, o.raw).shr(FracBits);
+            if (p.fits()) return Fixed(p.low());
+            return p.negative() ? min() : max();
+        } else {
+            return saturate((static_cast<Wide>(raw) * static_cast<Wide>(o.raw)) >> FracBits);
+        }
+    }
 
-    constexpr Fixed12 operator+(Fixed12 o) const {
-        return Fixed12(static_cast<i16>(raw + o.raw));
+    // Clamp a wide raw value into range
+    constexpr static Fixed saturate(Wide r) {
+        if (r > Traits::max) return max();
+        if (r < Traits::min) return min();
+        return Fixed(static_cast<Storage>(r));
+    }
+
+    constexpr Fixed& operator+=(Fixed o) {
+        raw = static_cast<Storage>(raw + o.raw);
+        return *this;
     }
 
-    constexpr Fixed12 operator-(Fixed12 o) const {
-        return Fixed12(static_cast<i16>(raw - o.raw));
+    constexpr Fixed& operator-=(Fixed o) {
+        raw = static_cast<Storage>(raw - o.raw);
+        return *this;
     }
+
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+    constexpr bool operator!=(Fixed o) const { return raw != o.raw; }
+    constexpr bool operator<(Fixed o) const { return raw < o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>(Fixed o) const { return raw > o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
 };
 
+// Raw value of v rescaled to To's fraction bits (shift amounts are
+// constants, so this is at most one shift at runtime)
+template<typename To, u8 I, u8 F, typename S>
+constexpr auto fixed_rescale(Fixed<I, F, S> v) {
+    using W = decltype(typename To::Wide() + typename Fixed<I, F, S>::Wide());
+    W r = v.raw;
+    if constexpr (To::frac_bits >= F) {
+        return static_cast<W>(r * (static_cast<W>(1) << (To::frac_bits - F)));
+    } else {
+        return static_cast<W>(r >> (F - To::frac_bits));
+    }
+}
+
+// Convert between formats; out-of-range values wrap
+template<typename To, u8 I, u8 F, typename S>
+constexpr To fixed_cast(Fixed<I, F, S> v) {
+    return To(static_cast<typename To::StorageType>(fixed_rescale<To>(v)));
+}
+
+// Convert between formats; out-of-range values clamp
+template<typename To, u8 I, u8 F, typename S>
+constexpr To saturate_cast(Fixed<I, F, S> v) {
+    auto r = fixed_rescale<To>(v);
+    if (r > To::Traits::max) return To::max();
+    if (r < To::Traits::min) return To::min();
+    return To(static_cast<typename To::StorageType>(r));
+}
+
+// 8.8 fixed point number
+using Fixed8 = Fixed<8, 8>;
+
+// 4.12 fixed point for higher precision (useful for angles/trig)
+using Fixed12 = Fixed<4, 12>;
+
 // BGR555 color (native SNES format)
 struct Color {
     u16 raw;
@@ -144,6 +389,11 @@ struct Rect {
     constexpr bool contains(i16 px, i16 py) const {
         return px >= x && px < right() && py >= y && py < bottom();
     }
+
+    // Whether the rectangles share any pixel (edges are exclusive)
+    constexpr bool overlaps(const Rect& o) const {
+        return x < o.right() && o.x < right() && y < o.bottom() && o.y < bottom();
+    }
 };
 
 } // namespace snes
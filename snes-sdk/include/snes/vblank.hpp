@@ -0,0 +1,95 @@
+#pragma once
+
+// SNES VBlank API - NMI hook table and frame counter
+//
+// The NMI handler in startup/crt0.s acknowledges the interrupt, increments
+// g_frame_count and then calls every non-null entry of g_hooks in slot order.
+// Hooks run with 16-bit A/X/Y, data bank 0 and a private direct page, so they
+// can be ordinary C++ functions without trampling the main loop's imaginary
+// registers.
+
+#include "types.hpp"
+#include "hal.hpp"
+#include "registers.hpp"
+
+namespace snes::vblank {
+
+// NMI hook signature
+using Hook = void (*)();
+
+// Number of hook slots (must match NMI_HOOK_COUNT in crt0.s)
+constexpr u8 MAX_HOOKS = 4;
+
+// Global state (defined in crt0.s, or src/vblank.cpp for SNES_TESTING)
+// crt0.s clears both at reset, before NMI can be enabled
+extern Hook g_hooks[MAX_HOOKS];
+extern volatile u16 g_frame_count;
+
+// ============================================================================
+// Hook Registration
+// ============================================================================
+
+// Register a hook to run on every NMI
+// Returns false if all slots are taken (registering twice is a no-op)
+inline bool add_hook(Hook hook) {
+    for (u8 i = 0; i < MAX_HOOKS; i++) {
+        if (g_hooks[i] == hook) return true;
+    }
+    for (u8 i = 0; i < MAX_HOOKS; i++) {
+        if (g_hooks[i] == nullptr) {
+            g_hooks[i] = hook;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Unregister a hook (no-op if it was never registered)
+inline void remove_hook(Hook hook) {
+    for (u8 i = 0; i < MAX_HOOKS; i++) {
+        if (g_hooks[i] == hook) g_hooks[i] = nullptr;
+    }
+}
+
+// Unregister all hooks
+inline void clear_hooks() {
+    for (u8 i = 0; i < MAX_HOOKS; i++) {
+        g_hooks[i] = nullptr;
+    }
+}
+
+// ============================================================================
+// NMI Control
+// ============================================================================
+
+// Enable NMI on VBlank (joypad auto-read stays enabled)
+inline void enable() {
+    hal::write8(reg::NMITIMEN::address, nmi::NMI_ENABLE | nmi::JOYPAD_ENABLE);
+}
+
+// Disable NMI (joypad auto-read stays enabled)
+inline void disable() {
+    hal::write8(reg::NMITIMEN::address, nmi::JOYPAD_ENABLE);
+}
+
+// Frames elapsed since reset (wraps at 65536)
+inline u16 frame_count() {
+    return g_frame_count;
+}
+
+// Wait until the NMI handler has run at least once
+// Requires enable(); unlike ppu::wait_vblank() this does not poll HVBJOY
+inline void wait_frame() {
+    u16 start = g_frame_count;
+    while (g_frame_count == start) {}
+}
+
+// Body of the crt0.s NMI handler, for custom NMI handlers and host tests
+inline void dispatch() {
+    g_frame_count = static_cast<u16>(g_frame_count + 1);
+    for (u8 i = 0; i < MAX_HOOKS; i++) {
+        if (g_hooks[i] != nullptr) g_hooks[i]();
+    }
+}
+
+} // namespace snes::vblank
@@ -0,0 +1,212 @@
+#pragma once
+
+// SNES VRAM API - Region allocator for tiles, tilemaps and sprite tiles
+//
+// VRAM is 32K words, managed here in 32 pages of 1K words. Each region kind
+// is aligned the way the PPU's base address registers require:
+//   TILEMAP    1K words  (BGnSC, see ppu::make_bgsc)
+//   BG_TILES   4K words  (BG12NBA/BG34NBA, see Background::set_tiles)
+//   OBJ_TILES  8K words  (OBSEL, see ppu::make_obsel)
+//
+// Regions can carry a non-zero key (e.g. an asset id). Acquiring a key that
+// is already resident shares the region and bumps its reference count.
+// Releasing the last reference does not free the pages straight away: the
+// region stays cached, with its data, until the space is needed. A scene
+// change that releases everything and acquires the next scene's assets
+// therefore only has to upload the regions that are not loaded().
+//
+//   u8 tiles = vram.acquire(vram::kind::BG_TILES, 0x1000, ASSET_FOREST);
+//   if (!vram.loaded(tiles)) {
+//       dma::transfer_to_vram(forest_tiles, vram.address(tiles), sizeof(forest_tiles));
+//       vram.mark_loaded(tiles);
+//   }
+
+#include "types.hpp"
+
+namespace snes::vram {
+
+constexpr u16 PAGE_WORDS = 0x400;  // 1K words (2KB)
+constexpr u8 PAGE_COUNT = 32;      // 64KB
+constexpr u8 MAX_REGIONS = 16;
+
+// Returned when a region cannot be allocated
+constexpr u8 NO_REGION = 0xFF;
+
+// Region kinds (value = alignment in pages)
+namespace kind {
+    constexpr u8 TILEMAP   = 1;
+    constexpr u8 BG_TILES  = 4;
+    constexpr u8 OBJ_TILES = 8;
+}
+
+struct Region {
+    u16 key;     // Sharing key (0 = private)
+    u8 first;    // First page
+    u8 pages;    // Length in pages (0 = slot unused)
+    u8 refs;     // References (0 = cached, evictable)
+    bool loaded; // Data uploaded (set by mark_loaded())
+};
+
+// Free-space summary
+struct Stats {
+    u8 free_pages;     // Pages not held by live or cached regions
+    u8 cached_pages;   // Pages held by cached (evictable) regions
+    u8 largest_free;   // Longest run of free pages
+    u8 free_runs;      // Number of separate free runs (1 = unfragmented)
+};
+
+// Plain data with no constructor: call reset() before first use
+struct Allocator {
+    Region regions[MAX_REGIONS];
+    u32 used;  // Bit per page held by a region (live or cached)
+
+    // Forget every region (VRAM contents are left as they are)
+    void reset() {
+        used = 0;
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            regions[i].pages = 0;
+        }
+    }
+
+    // Allocate a region of at least `words` words of the given kind
+    // key != 0: reuse a resident region with the same key if there is one
+    // Cached regions are evicted (lowest slot first) when space runs out
+    // Returns a region handle, or NO_REGION
+    u8 acquire(u8 region_kind, u16 words, u16 key = 0) {
+        if (key != 0) {
+            u8 existing = find(key);
+            if (existing != NO_REGION) {
+                regions[existing].refs++;
+                return existing;
+            }
+        }
+
+        u8 slot = NO_REGION;
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            if (regions[i].pages == 0) {
+                slot = i;
+                break;
+            }
+        }
+
+        u8 pages = static_cast<u8>((static_cast<u32>(words) + PAGE_WORDS - 1) / PAGE_WORDS);
+        if (pages == 0 || pages > PAGE_COUNT) return NO_REGION;
+
+        u8 first = find_space(region_kind, pages);
+        while (first == NO_REGION || slot == NO_REGION) {
+            u8 victim = first_cached();
+            if (victim == NO_REGION) return NO_REGION;
+            free_region(victim);
+            if (slot == NO_REGION) slot = victim;
+            first = find_space(region_kind, pages);
+        }
+
+        Region& r = regions[slot];
+        r.key = key;
+        r.first = first;
+        r.pages = pages;
+        r.refs = 1;
+        r.loaded = false;
+        used |= page_mask(first, pages);
+        return slot;
+    }
+
+    // Drop a reference; the last release leaves the region cached
+    void release(u8 handle) {
+        if (handle >= MAX_REGIONS || regions[handle].pages == 0) return;
+        Region& r = regions[handle];
+        if (r.refs > 0) r.refs--;
+        if (r.refs == 0 && r.key == 0) free_region(handle);  // Private data can't be reused
+    }
+
+    // Evict every cached region
+    void flush_cache() {
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            if (regions[i].pages != 0 && regions[i].refs == 0) free_region(i);
+        }
+    }
+
+    // Handle of the resident region with this key, or NO_REGION
+    u8 find(u16 key) const {
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            if (regions[i].pages != 0 && regions[i].key == key) return i;
+        }
+        return NO_REGION;
+    }
+
+    // VRAM word address of a region
+    u16 address(u8 handle) const {
+        return static_cast<u16>(regions[handle].first * PAGE_WORDS);
+    }
+
+    // Size of a region in words
+    u16 words(u8 handle) const {
+        return static_cast<u16>(regions[handle].pages * PAGE_WORDS);
+    }
+
+    bool loaded(u8 handle) const { return regions[handle].loaded; }
+    void mark_loaded(u8 handle) { regions[handle].loaded = true; }
+
+    Stats stats() const {
+        Stats s = {0, 0, 0, 0};
+        u8 run = 0;
+        for (u8 p = 0; p < PAGE_COUNT; p++) {
+            if (used & page_bit(p)) {
+                run = 0;
+            } else {
+                if (run == 0) s.free_runs++;
+                run++;
+                s.free_pages++;
+                if (run > s.largest_free) s.largest_free = run;
+            }
+        }
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            if (regions[i].pages != 0 && regions[i].refs == 0) {
+                s.cached_pages = static_cast<u8>(s.cached_pages + regions[i].pages);
+            }
+        }
+        return s;
+    }
+
+private:
+    static u32 page_bit(u8 page) { return static_cast<u32>(1) << page; }
+
+    static u32 page_mask(u8 first, u8 pages) {
+        u32 mask = 0;
+        for (u8 i = 0; i < pages; i++) mask |= page_bit(static_cast<u8>(first + i));
+        return mask;
+    }
+
+    // First aligned run of free pages: tilemaps search down from the top of
+    // VRAM and tile regions up from the bottom, so small tilemaps do not
+    // break up the large aligned blocks tiles need
+    u8 find_space(u8 align, u8 pages) const {
+        if (align == 0) align = 1;
+        u8 last_start = static_cast<u8>(PAGE_COUNT - pages);
+        if (align == kind::TILEMAP) {
+            for (u8 p = last_start + 1; p-- > 0;) {
+                if ((used & page_mask(p, pages)) == 0) return p;
+            }
+        } else {
+            for (u8 p = 0; p <= last_start; p = static_cast<u8>(p + align)) {
+                if ((used & page_mask(p, pages)) == 0) return p;
+            }
+        }
+        return NO_REGION;
+    }
+
+    u8 first_cached() const {
+        for (u8 i = 0; i < MAX_REGIONS; i++) {
+            if (regions[i].pages != 0 && regions[i].refs == 0) return i;
+        }
+        return NO_REGION;
+    }
+
+    void free_region(u8 handle) {
+        Region& r = regions[handle];
+        used &= ~page_mask(r.first, r.pages);
+        r.pages = 0;
+    }
+};
+
+} // namespace snes::vram
@@ -0,0 +1,19 @@
+// Audio state definitions for SNES_TESTING mode
+// In production builds, the g_audio_* variables are defined in crt0.s and
+// the command queue and stream are inline in the header
+
+#ifdef SNES_TESTING
+
+#include <snes/audio.hpp>
+
+namespace snes::audio {
+
+volatile u8 g_audio_initialized = 0;
+volatile u8 g_audio_master_volume = 0;
+volatile u8 g_audio_command_counter = 0;
+CommandQueue g_queue;
+Stream g_stream;
+
+} // namespace snes::audio
+
+#endif // SNES_TESTING
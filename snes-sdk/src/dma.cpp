@@ -0,0 +1,15 @@
+// DMA queue and channel allocator definitions for SNES_TESTING mode
+// In production builds, this is inline in the header
+
+#ifdef SNES_TESTING
+
+#include <snes/dma.hpp>
+
+namespace snes::dma {
+
+TransferQueue g_queue;
+ChannelAllocator g_channels;
+
+} // namespace snes::dma
+
+#endif // SNES_TESTING
@@ -0,0 +1,14 @@
+// Joypad latch definition for SNES_TESTING mode
+// In production builds, this is inline in the header
+
+#ifdef SNES_TESTING
+
+#include <snes/input.hpp>
+
+namespace snes::input {
+
+JoypadLatch g_latch;
+
+} // namespace snes::input
+
+#endif // SNES_TESTING
@@ -10,6 +10,7 @@ namespace snes::ppu {
 // OAM shadow buffers for testing
 OAMEntry oam_low[128];
 u8 oam_high[32];
+OamDirty oam_dirty;
 
 } // namespace snes::ppu
 
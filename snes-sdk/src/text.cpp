@@ -3,6 +3,8 @@
 
 #include <snes/text.hpp>
 #include <snes/registers.hpp>
+#include <snes/dma.hpp>
+#include <snes/vblank.hpp>
 
 namespace snes {
 namespace text {
@@ -10,6 +12,21 @@ namespace text {
 // Global state
 Cursor g_cursor = {0, 0};
 TextConfig g_config = {0x1000, 0, 0};
+u16 g_shadow[SCREEN_ROWS * SCREEN_COLS];
+volatile u32 g_dirty_rows = 0;
+volatile bool g_clear_pending = false;
+volatile bool g_updating = false;
+
+// Fill source for clear(), read by the DMA in flush()
+static u16 s_blank_entry = 0;
+
+// Budget used by the NMI hook
+static u16 s_nmi_budget = DEFAULT_FLUSH_BUDGET;
+
+// Tilemap entry for a font tile: tile number bits 0-9, palette bits 10-12
+static u16 make_entry(u16 tile) {
+    return static_cast<u16>((tile & 0x03FF) | ((g_config.palette & 0x07) << 10));
+}
 
 // Write a single character at cursor position
 void putchar(char c) {
@@ -41,24 +58,16 @@ void putchar(char c) {
     // Only printable ASCII (32-126)
     if (c < 32 || c > 126) c = '?';
 
-    // Calculate tilemap address
-    // Each row is SCREEN_COLS tiles, each tile entry is 2 bytes (tile + attributes)
-    u16 offset = (static_cast<u16>(g_cursor.y) * SCREEN_COLS + g_cursor.x);
-    u16 vram_addr = g_config.tilemap_addr + offset;
-
-    // Calculate tile number: font_tile_base + (character - 32)
-    u16 tile = g_config.font_tile_base + (c - 32);
-
-    // Write to VRAM
-    // Set VRAM address (word address)
-    reg::VMAIN::write(0x80);  // Increment after high byte write
-    reg::VMADDL::write(vram_addr & 0xFF);
-    reg::VMADDH::write(vram_addr >> 8);
+    // Calculate tile number: font_tile_base + (character - 32), kept to
+    // 10 bits so a font near the top of the tile range cannot carry into
+    // the palette, priority or flip bits
+    u16 tile = static_cast<u16>((g_config.font_tile_base + (c - 32)) & 0x03FF);
 
-    // Write tile entry (low byte = tile number, high byte = attributes)
-    u8 attr = (g_config.palette << 2);  // Palette bits 2-4
-    reg::VMDATAL::write(tile & 0xFF);
-    reg::VMDATAH::write(attr | ((tile >> 8) & 0x03));
+    // Write to the shadow tilemap and mark the row for the next flush
+    g_updating = true;
+    g_shadow[static_cast<u16>(g_cursor.y) * SCREEN_COLS + g_cursor.x] = make_entry(tile);
+    g_dirty_rows |= static_cast<u32>(1) << g_cursor.y;
+    g_updating = false;
 
     // Advance cursor
     g_cursor.x++;
@@ -84,53 +93,149 @@ void println(const char* str) {
 
 // Clear the text screen
 void clear() {
-    // Set VRAM address to tilemap start
-    reg::VMAIN::write(0x80);
-    reg::VMADDL::write(g_config.tilemap_addr & 0xFF);
-    reg::VMADDH::write(g_config.tilemap_addr >> 8);
+    // Space character tile (ASCII 32)
+    u16 entry = make_entry(g_config.font_tile_base);
 
-    // Space character tile
-    u16 space_tile = g_config.font_tile_base;  // ASCII 32 = space
-    u8 attr = (g_config.palette << 2);
-
-    // Fill screen with space characters
     for (u16 i = 0; i < SCREEN_COLS * SCREEN_ROWS; i++) {
-        reg::VMDATAL::write(space_tile & 0xFF);
-        reg::VMDATAH::write(attr | ((space_tile >> 8) & 0x03));
+        g_shadow[i] = entry;
     }
 
+    // VRAM is filled in one DMA by flush(), so per-row copies are redundant
+    g_updating = true;
+    s_blank_entry = entry;
+    g_clear_pending = true;
+    g_dirty_rows = 0;
+    g_updating = false;
+
     // Reset cursor
     g_cursor.x = 0;
     g_cursor.y = 0;
 }
 
-// Print unsigned 16-bit integer
-void print_u16(u16 value) {
-    char buf[6];  // Max 65535 = 5 digits + null
-    int i = 5;
-    buf[i] = '\0';
+// Fill the whole tilemap with s_blank_entry
+// (two single-byte passes unless both bytes of the entry match)
+static void fill_tilemap(u8 channel) {
+    dma::fill_vram(channel, g_config.tilemap_addr, &s_blank_entry, SCREEN_COLS * SCREEN_ROWS);
+}
 
-    if (value == 0) {
-        putchar('0');
-        return;
+// Copy changed rows to VRAM, up to budget bytes
+u16 flush(u16 budget) {
+    u8 channel = dma::g_channels.gpdma_channel();
+    u16 sent = 0;
+
+    if (g_clear_pending) {
+        fill_tilemap(channel);
+        g_clear_pending = false;
+        sent = SCREEN_BYTES;
     }
 
-    while (value > 0 && i > 0) {
-        i--;
-        buf[i] = '0' + (value % 10);
-        value /= 10;
+    u32 dirty = g_dirty_rows;
+    u8 row = 0;
+    while (dirty != 0) {
+        // Rows that still fit in the budget
+        u16 left = budget > sent ? static_cast<u16>((budget - sent) / ROW_BYTES) : 0;
+        if (left == 0) break;
+        u8 fit = left < SCREEN_ROWS ? static_cast<u8>(left) : SCREEN_ROWS;
+
+        // Skip clean rows
+        while ((dirty & 1) == 0) {
+            dirty >>= 1;
+            row++;
+        }
+
+        // Rows are contiguous in the tilemap, so a run is one transfer
+        u8 first = row;
+        while ((dirty & 1) && row - first < fit) {
+            dirty >>= 1;
+            row++;
+        }
+
+        // Only the sent rows are cleared; putchar() may mark more meanwhile
+        u32 run_mask = ((static_cast<u32>(1) << (row - first)) - 1) << first;
+        g_dirty_rows &= ~run_mask;
+
+        u16 offset = static_cast<u16>(first * SCREEN_COLS);
+        u16 size = static_cast<u16>((row - first) * ROW_BYTES);
+        dma::transfer_to_vram(channel, &g_shadow[offset],
+                              static_cast<u16>(g_config.tilemap_addr + offset), size);
+        sent = static_cast<u16>(sent + size);
     }
 
-    puts(&buf[i]);
+    return sent;
+}
+
+// Skipped when the NMI lands inside putchar() or clear(); the rows stay
+// dirty and go out next frame
+static void flush_nmi() {
+    if (g_updating) return;
+    flush(s_nmi_budget);
+}
+
+bool install_flush(u16 budget) {
+    s_nmi_budget = budget;
+    return vblank::add_hook(flush_nmi);
+}
+
+void uninstall_flush() {
+    vblank::remove_hook(flush_nmi);
+}
+
+// Powers of ten for format_u16
+static const u16 s_pow10[5] = {10000, 1000, 100, 10, 1};
+
+// Decimal conversion by repeated subtraction: at most 9 subtractions per
+// digit, where % and / would each be a runtime library call
+u8 format_u16(u16 value, char* digits) {
+    u8 significant = 1;
+    for (u8 i = 0; i < 5; i++) {
+        u16 step = s_pow10[i];
+        char d = '0';
+        while (value >= step) {
+            value = static_cast<u16>(value - step);
+            d++;
+        }
+        digits[i] = d;
+        if (d != '0' && significant == 1) significant = static_cast<u8>(5 - i);
+    }
+    return significant;
+}
+
+// Sign, padding and digits, right-aligned in width columns
+static void print_padded(bool negative, u16 magnitude, u8 width, char pad) {
+    char digits[5];
+    u8 count = format_u16(magnitude, digits);
+    u8 used = static_cast<u8>(count + (negative ? 1 : 0));
+    u8 fill = width > used ? static_cast<u8>(width - used) : 0;
+
+    // Zero fill follows the sign, other padding precedes it
+    if (negative && pad == '0') putchar('-');
+    for (u8 i = 0; i < fill; i++) putchar(pad);
+    if (negative && pad != '0') putchar('-');
+
+    for (u8 i = static_cast<u8>(5 - count); i < 5; i++) putchar(digits[i]);
+}
+
+// Magnitude of a signed value (-32768 included)
+static u16 magnitude(i16 value) {
+    return value < 0 ? static_cast<u16>(0u - static_cast<u16>(value)) : static_cast<u16>(value);
+}
+
+// Print unsigned 16-bit integer
+void print_u16(u16 value) {
+    print_padded(false, value, 0, ' ');
+}
+
+void print_u16(u16 value, u8 width, char pad) {
+    print_padded(false, value, width, pad);
 }
 
 // Print signed 16-bit integer
 void print_i16(i16 value) {
-    if (value < 0) {
-        putchar('-');
-        value = -value;
-    }
-    print_u16(static_cast<u16>(value));
+    print_padded(value < 0, magnitude(value), 0, ' ');
+}
+
+void print_i16(i16 value, u8 width, char pad) {
+    print_padded(value < 0, magnitude(value), width, pad);
 }
 
 // Print hex value (4 digits)
@@ -0,0 +1,15 @@
+// VBlank hook state for SNES_TESTING mode
+// In production builds, these are defined in startup/crt0.s
+
+#ifdef SNES_TESTING
+
+#include <snes/vblank.hpp>
+
+namespace snes::vblank {
+
+Hook g_hooks[MAX_HOOKS];
+volatile u16 g_frame_count = 0;
+
+} // namespace snes::vblank
+
+#endif // SNES_TESTING
@@ -24,6 +24,21 @@
 ; Export entry point
 .export reset, nmi_handler, irq_handler
 
+; Export VBlank hook state (snes::vblank::g_hooks, snes::vblank::g_frame_count)
+.export _ZN4snes6vblank7g_hooksE
+.export _ZN4snes6vblank13g_frame_countE
+
+; Number of NMI hook slots (must match snes::vblank::MAX_HOOKS)
+NMI_HOOK_COUNT = 4
+
+.segment "BSS"
+_ZN4snes6vblank7g_hooksE:        .res NMI_HOOK_COUNT * 2
+_ZN4snes6vblank13g_frame_countE: .res 2
+
+; Private direct page for NMI hooks, so compiled code called from the
+; NMI handler does not clobber the main loop's imaginary registers
+nmi_direct_page:                 .res $100
+
 .segment "STARTUP"
 
 reset:
@@ -42,6 +57,15 @@ reset:
     lda #$0000
     tcd
 
+    ; Clear VBlank hook table and frame counter (BSS is not zeroed)
+    ldx #(NMI_HOOK_COUNT * 2 - 2)
+@clear_hooks:
+    stz _ZN4snes6vblank7g_hooksE,x
+    dex
+    dex
+    bpl @clear_hooks
+    stz _ZN4snes6vblank13g_frame_countE
+
     ; Clear PPU registers
     sep #$20                ; 8-bit A
     .a8
@@ -774,7 +798,53 @@ load_player_palette:
 
 
 ; NMI Handler (VBlank)
+; Increments the frame counter and calls each registered hook in slot order
+; (see snes/vblank.hpp). NMI is only enabled once the game calls
+; snes::vblank::enable().
 nmi_handler:
+    rep #$30                ; 16-bit A/X/Y
+    .a16
+    .i16
+    pha
+    phx
+    phy
+    phd
+    phb
+
+    ; Data bank 0, private direct page
+    pea $0000
+    plb
+    plb
+    lda #nmi_direct_page
+    tcd
+
+    sep #$20
+    .a8
+    lda $4210               ; Acknowledge NMI (RDNMI)
+    rep #$20
+    .a16
+
+    inc _ZN4snes6vblank13g_frame_countE
+
+    ldx #0
+@hook_loop:
+    lda _ZN4snes6vblank7g_hooksE,x
+    beq @next_hook
+    phx
+    jsr (_ZN4snes6vblank7g_hooksE,x)
+    rep #$30                ; Hooks may return with 8-bit registers
+    plx
+@next_hook:
+    inx
+    inx
+    cpx #(NMI_HOOK_COUNT * 2)
+    bcc @hook_loop
+
+    plb
+    pld
+    ply
+    plx
+    pla
     rti
 
 ; IRQ Handler
@@ -86,9 +86,15 @@ struct FakeRegisterAccess : hal::IRegisterAccess {
         return 0;  // Default return value
     }
 
+    // Recorded as two byte writes (low first, as the CPU performs them),
+    // both flagged is_16bit so tests can tell them from separate stores
     void write16(u32 addr, u16 val) override {
         write8(addr, static_cast<u8>(val & 0xFF));
         write8(addr + 1, static_cast<u8>(val >> 8));
+        if (write_count >= 2 && writes[write_count - 2].addr == addr) {
+            writes[write_count - 2].is_16bit = true;
+            writes[write_count - 1].is_16bit = true;
+        }
     }
 
     u16 read16(u32 addr) override {
@@ -140,6 +146,31 @@ struct FakeRegisterAccess : hal::IRegisterAccess {
         return count;
     }
 
+    // Count 16-bit stores to a register pair starting at addr
+    int count_writes16(u32 addr) const {
+        int count = 0;
+        for (int i = 0; i + 1 < write_count; i++) {
+            if (writes[i].addr == addr && writes[i].is_16bit &&
+                writes[i + 1].addr == addr + 1 && writes[i + 1].is_16bit) {
+                count++;
+                i++;
+            }
+        }
+        return count;
+    }
+
+    // Check if a 16-bit store of val was made to the pair at addr
+    bool wrote16(u32 addr, u16 val) const {
+        for (int i = 0; i + 1 < write_count; i++) {
+            if (writes[i].addr == addr && writes[i].is_16bit &&
+                writes[i + 1].addr == addr + 1 && writes[i + 1].is_16bit &&
+                writes[i].value == (val & 0xFF) && writes[i + 1].value == (val >> 8)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     // Get all writes in order
     int get_writes(u32 addr, u8* out_values, int max_count) const {
         int count = 0;
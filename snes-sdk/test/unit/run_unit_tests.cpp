@@ -19,6 +19,19 @@
 #include "fake_hal.hpp"
 #include "test_joypad.cpp"
 #include "test_sprite.cpp"
+#include "test_dma_queue.cpp"
+#include "test_dma_channels.cpp"
+#include "test_dma_batch.cpp"
+#include "test_registers.cpp"
+#include "test_hdma.cpp"
+#include "test_mode7.cpp"
+#include "test_vram.cpp"
+#include "test_scroll.cpp"
+#include "test_text.cpp"
+#include "test_math_hw.cpp"
+#include "test_entity.cpp"
+#include "test_collision.cpp"
+#include "test_audio.cpp"
 
 int main() {
     std::printf("SNES SDK Unit Tests\n");
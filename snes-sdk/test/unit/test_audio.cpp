@@ -0,0 +1,776 @@
+// Unit tests for the APU command queue
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/audio.hpp>
+#include <cstdlib>
+
+using namespace snes;
+
+// Fake SPC700 driver: echoes the last APUIO0 byte once acknowledge() runs
+struct FakeApu : snes::testing::FakeRegisterAccess {
+    u8 port0 = 0;  // CPU -> APU
+    u8 port1 = 0;
+    u8 echo = 0;   // APU -> CPU
+    int commands = 0;
+    u8 taken_op[16];
+    u8 taken_param[16];
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr == reg::APUIO0::address) port0 = val;
+        if (addr == reg::APUIO1::address) port1 = val;
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr == reg::APUIO0::address) return echo;
+        return FakeRegisterAccess::read8(addr);
+    }
+
+    // The driver's main loop: take a new command and echo it
+    void acknowledge() {
+        if (port0 == echo) return;
+        echo = port0;
+        if (commands < 16) {
+            taken_op[commands] = static_cast<u8>(port0 >> 4);
+            taken_param[commands] = port1;
+        }
+        commands++;
+    }
+};
+
+struct AudioTestFixture {
+    FakeApu apu;
+
+    AudioTestFixture() {
+        hal::set_hal(apu);
+        audio::init();
+    }
+};
+
+TEST(audio_commands_wait_for_service) {
+    AudioTestFixture f;
+
+    audio::play_sfx(audio::SFX_JUMP);
+    audio::play_sfx(audio::SFX_COIN);
+
+    ASSERT_EQ(f.apu.write_count, 0);
+    ASSERT_EQ(audio::g_queue.count, 2);
+}
+
+TEST(audio_service_never_overwrites_unacknowledged) {
+    AudioTestFixture f;
+
+    audio::play_sfx(audio::SFX_JUMP);
+    audio::play_sfx(audio::SFX_COIN);
+
+    ASSERT_TRUE(audio::service());
+    ASSERT_EQ(f.apu.count_writes(reg::APUIO0::address), 1);
+
+    // APU busy: the second command stays queued and nothing is written
+    ASSERT_FALSE(audio::service());
+    ASSERT_FALSE(audio::service());
+    ASSERT_EQ(f.apu.count_writes(reg::APUIO0::address), 1);
+    ASSERT_EQ(audio::g_queue.busy, 2);
+
+    f.apu.acknowledge();
+    ASSERT_TRUE(audio::service());
+    f.apu.acknowledge();
+    ASSERT_FALSE(audio::service());
+    ASSERT_TRUE(audio::g_queue.idle());
+
+    ASSERT_EQ(f.apu.commands, 2);
+    ASSERT_EQ(f.apu.taken_op[0], audio::cmd::PLAY_SFX);
+    ASSERT_EQ(f.apu.taken_param[0], audio::SFX_JUMP);
+    ASSERT_EQ(f.apu.taken_param[1], audio::SFX_COIN);
+}
+
+TEST(audio_queue_coalesces) {
+    AudioTestFixture f;
+
+    audio::play_sfx(audio::SFX_COIN);
+    audio::play_sfx(audio::SFX_COIN);
+    audio::set_master_volume(20);
+    audio::set_master_volume(90);
+    audio::play_music(audio::MUSIC_TITLE);
+    audio::stop_music();
+    audio::play_music(audio::MUSIC_GAME);
+
+    // One coin, one volume change, one music change
+    ASSERT_EQ(audio::g_queue.count, 3);
+
+    while (!audio::g_queue.idle()) {
+        audio::service();
+        f.apu.acknowledge();
+    }
+    ASSERT_EQ(f.apu.commands, 3);
+
+    // HIGH priority commands go first
+    ASSERT_EQ(f.apu.taken_op[0], audio::cmd::SET_VOLUME);
+    ASSERT_EQ(f.apu.taken_param[0], 90);
+    ASSERT_EQ(f.apu.taken_op[1], audio::cmd::PLAY_MUSIC);
+    ASSERT_EQ(f.apu.taken_param[1], audio::MUSIC_GAME);
+    ASSERT_EQ(f.apu.taken_op[2], audio::cmd::PLAY_SFX);
+}
+
+TEST(audio_stop_all_discards_pending_playback) {
+    AudioTestFixture f;
+
+    audio::play_sfx(audio::SFX_JUMP);
+    audio::play_music(audio::MUSIC_TITLE);
+    audio::set_sfx_volume(50);
+    audio::stop_all();
+
+    ASSERT_EQ(audio::g_queue.count, 2);
+    audio::service();
+    f.apu.acknowledge();
+    audio::service();
+
+    ASSERT_EQ(f.apu.taken_op[0], audio::cmd::SET_SFX_VOL);
+    ASSERT_EQ(f.apu.port0 >> 4, audio::cmd::STOP_ALL);
+}
+
+TEST(audio_full_queue_keeps_higher_priority) {
+    AudioTestFixture f;
+
+    for (u8 i = 0; i < audio::QUEUE_SIZE; i++) {
+        ASSERT_TRUE(audio::g_queue.push(audio::cmd::PLAY_SFX, i, audio::priority::LOW));
+    }
+
+    // Equal priority is dropped, higher displaces the newest LOW command
+    ASSERT_FALSE(audio::g_queue.push(audio::cmd::PLAY_SFX, 100, audio::priority::LOW));
+    ASSERT_TRUE(audio::g_queue.push(audio::cmd::PLAY_SFX, 101, audio::priority::NORMAL));
+    ASSERT_EQ(audio::g_queue.count, audio::QUEUE_SIZE);
+    ASSERT_EQ(audio::g_queue.dropped, 2);
+
+    audio::service();
+    ASSERT_EQ(f.apu.port1, 101);
+
+    // The remaining LOW commands follow in order, minus the displaced one
+    for (u8 i = 0; i < audio::QUEUE_SIZE - 1; i++) {
+        f.apu.acknowledge();
+        audio::service();
+        ASSERT_EQ(f.apu.port1, i);
+    }
+    ASSERT_EQ(audio::g_queue.count, 0);
+}
+
+TEST(audio_commands_ignored_before_init) {
+    AudioTestFixture f;
+
+    audio::g_audio_initialized = 0;
+    audio::play_sfx(audio::SFX_BEEP);
+    ASSERT_EQ(audio::g_queue.count, 0);
+    audio::init();
+}
+
+// ============================================================================
+// Driver upload
+// ============================================================================
+
+// Minimal SPC700: the instructions used by the IPL ROM, the upload loader
+// and the test driver, plus the CPU ports and CONTROL. Each CPU access to
+// the ports lets it run CPU_ACCESS_CYCLES cycles (about one HAL call of
+// compiled 65816 code).
+struct FakeSpc700 : snes::testing::FakeRegisterAccess {
+    static constexpr int CPU_ACCESS_CYCLES = 8;
+    static constexpr long CYCLE_LIMIT = 20000000;
+
+    u8 ram[0x10000];
+    u8 in[4] = {0, 0, 0, 0};   // CPU -> SPC700
+    u8 out[4] = {0, 0, 0, 0};  // SPC700 -> CPU
+    bool rom_enabled = true;
+    u16 pc = 0xFFC0;
+    u8 a = 0, x = 0, y = 0, sp = 0;
+    bool n = false, z = false, c = false;
+    long cycles = 0;
+    int budget = 0;
+    bool in_store16 = false;
+
+    FakeSpc700() {
+        std::memset(ram, 0x55, sizeof(ram));
+    }
+
+    static const u8* ipl_rom() {
+        static const u8 rom[64] = {
+            0xCD, 0xEF, 0xBD, 0xE8, 0x00, 0xC6, 0x1D, 0xD0, 0xFC, 0x8F, 0xAA, 0xF4, 0x8F, 0xBB, 0xF5, 0x78,
+            0xCC, 0xF4, 0xD0, 0xFB, 0x2F, 0x19, 0xEB, 0xF4, 0xD0, 0xFC, 0x7E, 0xF4, 0xD0, 0x0B, 0xE4, 0xF5,
+            0xCB, 0xF4, 0xD7, 0x00, 0xFC, 0xD0, 0xF3, 0xAB, 0x01, 0x10, 0xEF, 0x7E, 0xF4, 0x10, 0xEB, 0xBA,
+            0xF6, 0xDA, 0x00, 0xBA, 0xF4, 0xC4, 0xF4, 0xDD, 0x5D, 0xD0, 0xDB, 0x1F, 0x00, 0x00, 0xC0, 0xFF,
+        };
+        return rom;
+    }
+
+    u8 mem(u16 addr) const {
+        if (addr >= 0xF4 && addr <= 0xF7) return in[addr - 0xF4];
+        if (addr >= 0xFFC0 && rom_enabled) return ipl_rom()[addr - 0xFFC0];
+        return ram[addr];
+    }
+
+    void store(u16 addr, u8 val) {
+        if (addr == 0xF1) {
+            if (val & 0x10) in[0] = in[1] = 0;
+            if (val & 0x20) in[2] = in[3] = 0;
+            rom_enabled = (val & 0x80) != 0;
+        } else if (addr >= 0xF4 && addr <= 0xF7) {
+            out[addr - 0xF4] = val;
+            return;
+        }
+        ram[addr] = val;
+    }
+
+    u8 fetch() { return mem(pc++); }
+    u16 fetch_abs() {
+        u8 lo = fetch();
+        return static_cast<u16>(lo | (fetch() << 8));
+    }
+    u16 dp_word(u8 d) const { return static_cast<u16>(mem(d) | (mem(static_cast<u8>(d + 1)) << 8)); }
+    void nz(u8 v) { n = (v & 0x80) != 0; z = v == 0; }
+    void compare(u8 r, u8 m) { c = r >= m; nz(static_cast<u8>(r - m)); }
+
+    int branch(bool taken) {
+        i8 offset = static_cast<i8>(fetch());
+        if (!taken) return 2;
+        pc = static_cast<u16>(pc + offset);
+        return 4;
+    }
+
+    int step() {
+        u8 op = fetch();
+        u8 d;
+        switch (op) {
+            case 0xCD: x = fetch(); nz(x); return 2;
+            case 0xAD: compare(y, fetch()); return 2;
+            case 0x8D: y = fetch(); nz(y); return 2;
+            case 0xE8: a = fetch(); nz(a); return 2;
+            case 0xBD: sp = x; return 2;
+            case 0xDD: a = y; nz(a); return 2;
+            case 0x5D: x = a; nz(x); return 2;
+            case 0x1D: x--; nz(x); return 2;
+            case 0x3D: x++; nz(x); return 2;
+            case 0xFC: y++; nz(y); return 2;
+            case 0xC6: store(x, a); return 4;
+            case 0xE4: a = mem(fetch()); nz(a); return 3;
+            case 0xEB: y = mem(fetch()); nz(y); return 3;
+            case 0xC4: store(fetch(), a); return 4;
+            case 0xCB: store(fetch(), y); return 4;
+            case 0xD8: store(fetch(), x); return 4;
+            case 0x8F: { u8 imm = fetch(); store(fetch(), imm); return 5; }
+            case 0x78: { u8 imm = fetch(); compare(mem(fetch()), imm); return 5; }
+            case 0x3E: compare(x, mem(fetch())); return 3;
+            case 0x7E: compare(y, mem(fetch())); return 3;
+            case 0xAB: d = fetch(); store(d, static_cast<u8>(mem(d) + 1)); nz(mem(d)); return 4;
+            case 0x8B: d = fetch(); store(d, static_cast<u8>(mem(d) - 1)); nz(mem(d)); return 4;
+            case 0xD7: d = fetch(); store(static_cast<u16>(dp_word(d) + y), a); return 7;
+            case 0xBA:
+                d = fetch();
+                a = mem(d);
+                y = mem(static_cast<u8>(d + 1));
+                n = (y & 0x80) != 0;
+                z = (a | y) == 0;
+                return 5;
+            case 0xDA: d = fetch(); store(d, a); store(static_cast<u8>(d + 1), y); return 5;
+            case 0x3A: {
+                d = fetch();
+                u16 w = static_cast<u16>(dp_word(d) + 1);
+                store(d, static_cast<u8>(w));
+                store(static_cast<u8>(d + 1), static_cast<u8>(w >> 8));
+                n = (w & 0x8000) != 0;
+                z = w == 0;
+                return 6;
+            }
+            case 0xE5: a = mem(fetch_abs()); nz(a); return 4;
+            case 0x64: compare(a, mem(fetch())); return 3;
+            case 0x65: compare(a, mem(fetch_abs())); return 4;
+            case 0x68: compare(a, fetch()); return 2;
+            case 0x5E: compare(y, mem(fetch_abs())); return 4;
+            case 0xDC: y--; nz(y); return 2;
+            case 0x5C: c = (a & 1) != 0; a = static_cast<u8>(a >> 1); nz(a); return 2;
+            case 0x5F: pc = fetch_abs(); return 3;
+            case 0xC5: store(fetch_abs(), a); return 5;
+            case 0xCC: store(fetch_abs(), y); return 5;
+            case 0xD6: store(static_cast<u16>(fetch_abs() + y), a); return 6;
+            case 0xD0: return branch(!z);
+            case 0xF0: return branch(z);
+            case 0x10: return branch(!n);
+            case 0x2F: return branch(true);
+            case 0x1F: {
+                u16 ptr = static_cast<u16>(fetch_abs() + x);
+                pc = static_cast<u16>(mem(ptr) | (mem(static_cast<u16>(ptr + 1)) << 8));
+                return 6;
+            }
+            default:
+                std::printf("FakeSpc700: unknown opcode %02X at %04X\n", op, pc - 1);
+                std::fflush(stdout);
+            std::abort();
+        }
+    }
+
+    void run(int spc_cycles) {
+        budget += spc_cycles;
+        while (budget > 0) {
+            int used = step();
+            budget -= used;
+            cycles += used;
+        }
+        if (cycles > CYCLE_LIMIT) {
+            std::printf("FakeSpc700: CPU never finished (pc %04X)\n", pc);
+            std::fflush(stdout);
+            std::abort();
+        }
+    }
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr >= reg::APUIO0::address && addr <= reg::APUIO3::address) {
+            in[addr - reg::APUIO0::address] = val;
+            if (!in_store16) run(CPU_ACCESS_CYCLES);
+        }
+    }
+
+    // Both bytes land before the SPC700 runs again
+    void write16(u32 addr, u16 val) override {
+        in_store16 = true;
+        FakeRegisterAccess::write16(addr, val);
+        in_store16 = false;
+        run(CPU_ACCESS_CYCLES);
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr >= reg::APUIO0::address && addr <= reg::APUIO3::address) {
+            run(CPU_ACCESS_CYCLES);
+            return out[addr - reg::APUIO0::address];
+        }
+        return FakeRegisterAccess::read8(addr);
+    }
+};
+
+// Test driver: signal ready as spc700_driver.s does, then idle
+static const u8 k_test_driver[] = {
+    0x8F, 0x00, 0xF4,  // mov $F4,#$00
+    0x8F, 0xAA, 0xF5,  // mov $F5,#$AA
+    0x2F, 0xFE,        // bra *
+};
+
+static void fill_pattern(u8* data, u16 size, u8 seed) {
+    for (u16 i = 0; i < size; i++) data[i] = static_cast<u8>(seed + i * 7 + (i >> 8));
+}
+
+TEST(audio_upload_copies_blocks_and_runs_entry) {
+    static FakeSpc700 spc;
+    spc = FakeSpc700();
+    hal::set_hal(spc);
+
+    static u8 samples[1000];  // 333 groups and a remainder
+    u8 table[4];
+    fill_pattern(samples, sizeof(samples), 3);
+    fill_pattern(table, sizeof(table), 200);
+    const audio::ipl::Block blocks[] = {
+        {0x0300, k_test_driver, sizeof(k_test_driver)},
+        {0x0400, table, sizeof(table)},
+        {0x80FE, samples, sizeof(samples)},
+    };
+
+    ASSERT_TRUE(audio::ipl::upload(blocks, 3, 0x0300));
+    spc.run(100);
+
+    ASSERT_TRUE(std::memcmp(&spc.ram[0x0300], k_test_driver, sizeof(k_test_driver)) == 0);
+    ASSERT_TRUE(std::memcmp(&spc.ram[0x0400], table, sizeof(table)) == 0);
+    ASSERT_TRUE(std::memcmp(&spc.ram[0x80FE], samples, sizeof(samples)) == 0);
+
+    // Nothing written past a block
+    ASSERT_EQ(spc.ram[0x0400 + sizeof(table)], 0x55);
+    ASSERT_EQ(spc.ram[0x80FE + sizeof(samples)], 0x55);
+
+    // The driver is running with the ports cleared and the IPL ROM off
+    ASSERT_EQ(spc.out[1], audio::cmd::READY);
+    ASSERT_EQ(spc.in[0], 0);
+    ASSERT_FALSE(spc.rom_enabled);
+    ASSERT_TRUE(spc.pc >= 0x0300 && spc.pc < 0x0300 + sizeof(k_test_driver));
+}
+
+TEST(audio_upload_rejects_short_block) {
+    AudioTestFixture f;
+    const u8 two[2] = {1, 2};
+    const audio::ipl::Block block = {0x0400, two, 2};
+
+    ASSERT_FALSE(audio::ipl::upload(&block, 1, 0x0400));
+    ASSERT_EQ(f.apu.write_count, 0);
+}
+
+TEST(audio_init_with_image_waits_for_driver) {
+    static FakeSpc700 spc;
+    spc = FakeSpc700();
+    hal::set_hal(spc);
+    audio::g_audio_initialized = 0;
+
+    const audio::ipl::Block block = {0x0300, k_test_driver, sizeof(k_test_driver)};
+    ASSERT_TRUE(audio::init(&block, 1, 0x0300));
+    ASSERT_TRUE(audio::is_ready());
+    ASSERT_TRUE(audio::g_queue.idle());
+}
+
+TEST(audio_loader_faster_than_ipl) {
+    static u8 samples[4096];
+    fill_pattern(samples, sizeof(samples), 9);
+    const audio::ipl::Block blocks[] = {
+        {0x0300, k_test_driver, sizeof(k_test_driver)},
+        {0x1000, samples, sizeof(samples)},
+    };
+
+    static FakeSpc700 fast;
+    fast = FakeSpc700();
+    hal::set_hal(fast);
+    audio::ipl::upload(blocks, 2, 0x0300);
+
+    static FakeSpc700 slow;
+    slow = FakeSpc700();
+    hal::set_hal(slow);
+    audio::ipl::detail::wait_ipl();
+    u8 kick = audio::ipl::detail::ipl_write(0xCC, 0x0300, k_test_driver, sizeof(k_test_driver));
+    kick = audio::ipl::detail::ipl_write(kick, 0x1000, samples, sizeof(samples));
+    audio::ipl::detail::ipl_exec(kick, 0x0300);
+
+    ASSERT_TRUE(std::memcmp(&slow.ram[0x1000], samples, sizeof(samples)) == 0);
+    ASSERT_TRUE(std::memcmp(&fast.ram[0x1000], samples, sizeof(samples)) == 0);
+    // At least 1.4x faster, loader upload included
+    ASSERT_LT(fast.cycles * 7, slow.cycles * 5);
+}
+
+// ============================================================================
+// Background streaming
+// ============================================================================
+
+// The running driver's protocol, answering each APUIO0 write at once:
+// commands are echoed, RECEIVE copies groups into ram
+struct FakeDriver : snes::testing::FakeRegisterAccess {
+    u8 ram[0x10000];
+    u8 in[4] = {0, 0, 0, 0};
+    u8 echo = 0;
+    u8 counter = 0;      // Last command byte taken
+    int commands = 0;
+    int receives = 0;
+    bool receiving = false;
+    bool ending = false;
+    u16 ptr = 0;
+    u8 length = 0;
+    u8 next = 0;          // Next expected offset
+
+    FakeDriver() {
+        std::memset(ram, 0x55, sizeof(ram));
+    }
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr >= reg::APUIO0::address && addr <= reg::APUIO3::address) {
+            in[addr - reg::APUIO0::address] = val;
+            if (addr == reg::APUIO0::address) step();
+        }
+    }
+
+    // 16-bit stores land together, like the CPU's two consecutive writes
+    void write16(u32 addr, u16 val) override {
+        FakeRegisterAccess::write8(addr, static_cast<u8>(val));
+        FakeRegisterAccess::write8(addr + 1, static_cast<u8>(val >> 8));
+        in[addr - reg::APUIO0::address] = static_cast<u8>(val);
+        in[addr + 1 - reg::APUIO0::address] = static_cast<u8>(val >> 8);
+        if (addr == reg::APUIO0::address) step();
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr == reg::APUIO0::address) return echo;
+        return FakeRegisterAccess::read8(addr);
+    }
+
+    void step() {
+        if (ending) {
+            if (in[0] != counter) return;
+            echo = counter;
+            ending = false;
+        } else if (receiving) {
+            if (in[0] != next) return;
+            ram[static_cast<u16>(ptr + next)] = in[1];
+            ram[static_cast<u16>(ptr + next + 1)] = in[2];
+            ram[static_cast<u16>(ptr + next + 2)] = in[3];
+            echo = next;
+            next = static_cast<u8>(next + 3);
+            if (next == length) {
+                receiving = false;
+                ending = true;
+            }
+        } else if (in[0] != counter) {
+            counter = in[0];
+            echo = counter;
+            commands++;
+            if ((counter >> 4) == audio::cmd::RECEIVE) {
+                ASSERT_EQ(in[1] % 3, 0);
+                ASSERT_TRUE(in[1] > 0 && in[1] < 0x80);
+                receives++;
+                ptr = static_cast<u16>(in[2] | (in[3] << 8));
+                length = in[1];
+                next = 0;
+                receiving = true;
+            }
+        }
+    }
+};
+
+struct StreamTestFixture {
+    static FakeDriver& driver() {
+        static FakeDriver d;
+        return d;
+    }
+
+    StreamTestFixture() {
+        driver() = FakeDriver();
+        hal::set_hal(driver());
+        audio::init();
+    }
+};
+
+TEST(audio_stream_copies_across_frames) {
+    StreamTestFixture f;
+    FakeDriver& d = f.driver();
+    static u8 bank[1000];  // 9-byte BRR blocks plus a remainder
+    fill_pattern(bank, sizeof(bank), 17);
+
+    ASSERT_TRUE(audio::stream(0x9000, bank, sizeof(bank)));
+    ASSERT_TRUE(audio::streaming());
+
+    int frames = 0;
+    while (audio::streaming()) {
+        ASSERT_TRUE(audio::service());
+        frames++;
+    }
+
+    // 252 bytes a call in chunks of 126 (the fake driver answers at
+    // once); the last byte goes in an overlapping 3-byte chunk
+    ASSERT_EQ(frames, 4);
+    ASSERT_EQ(d.receives, 9);
+    ASSERT_TRUE(std::memcmp(&d.ram[0x9000], bank, sizeof(bank)) == 0);
+    ASSERT_EQ(d.ram[0x9000 + sizeof(bank)], 0x55);
+    ASSERT_FALSE(d.receiving || d.ending);
+    ASSERT_TRUE(audio::g_queue.idle());
+}
+
+TEST(audio_stream_yields_to_commands) {
+    StreamTestFixture f;
+    FakeDriver& d = f.driver();
+    static u8 bank[300];
+    fill_pattern(bank, sizeof(bank), 5);
+
+    audio::stream(0x2000, bank, sizeof(bank));
+    audio::play_sfx(audio::SFX_COIN);
+
+    // The command goes first, the stream continues on the next frame
+    ASSERT_TRUE(audio::service());
+    ASSERT_EQ(d.commands, 1);
+    ASSERT_EQ(audio::g_stream.sent, 0);
+    ASSERT_TRUE(audio::service());
+    ASSERT_EQ(audio::g_stream.sent, 252);
+
+    // A command after the stream is still acknowledged normally
+    audio::play_sfx(audio::SFX_JUMP);
+    ASSERT_TRUE(audio::service());
+    ASSERT_EQ(d.counter >> 4, audio::cmd::PLAY_SFX);
+    ASSERT_EQ(audio::g_stream.sent, 252);
+    ASSERT_TRUE(audio::service());
+    ASSERT_FALSE(audio::streaming());
+    ASSERT_TRUE(std::memcmp(&d.ram[0x2000], bank, sizeof(bank)) == 0);
+}
+
+TEST(audio_stream_waits_for_busy_driver) {
+    StreamTestFixture f;
+    FakeDriver& d = f.driver();
+    u8 bank[9];
+    fill_pattern(bank, sizeof(bank), 1);
+
+    // Last command not echoed yet: nothing is sent, nothing waits
+    audio::play_sfx(audio::SFX_BEEP);
+    audio::service();
+    d.echo = 0;
+    audio::stream(0x3000, bank, sizeof(bank));
+    ASSERT_FALSE(audio::service());
+    ASSERT_EQ(d.receives, 0);
+
+    d.echo = d.counter;
+    ASSERT_TRUE(audio::service());
+    ASSERT_EQ(d.receives, 1);
+    ASSERT_TRUE(std::memcmp(&d.ram[0x3000], bank, sizeof(bank)) == 0);
+}
+
+// spc700_driver.s main loop and cmd_receive with the other commands left
+// out, assembled at $0300 (drv_param = $0201, drv_counter = $0202)
+static const u8 k_receive_driver[] = {
+    0x8F, 0x00, 0xF4,        //       mov CPUIO0,#$00
+    0x8F, 0xAA, 0xF5,        //       mov CPUIO1,#$AA
+    0xE4, 0xF4,              // main: mov A,CPUIO0
+    0x65, 0x02, 0x02,        //       cmp A,drv_counter
+    0xF0, 0xF9,              //       beq main
+    0xC5, 0x02, 0x02,        //       mov drv_counter,A
+    0xE4, 0xF5,              //       mov A,CPUIO1
+    0xC5, 0x01, 0x02,        //       mov drv_param,A
+    0xBA, 0xF6,              //       movw YA,CPUIO2
+    0xDA, 0x00,              //       movw recv_ptr,YA
+    0xE5, 0x02, 0x02,        //       mov A,drv_counter
+    0xC4, 0xF4,              //       mov CPUIO0,A
+    0x5C, 0x5C, 0x5C, 0x5C,  //       lsr A (x4)
+    0x68, 0x08,              //       cmp A,#$08
+    0xD0, 0xE0,              //       bne main
+    0x8D, 0x00,              //       mov Y,#$00
+    0x5E, 0x01, 0x02,        // grp:  cmp Y,drv_param
+    0xF0, 0x1B,              //       beq end
+    0x7E, 0xF4,              // wait: cmp Y,CPUIO0
+    0xD0, 0xFC,              //       bne wait
+    0xE4, 0xF5,              //       mov A,CPUIO1
+    0xD7, 0x00,              //       mov [recv_ptr]+Y,A
+    0xFC,                    //       inc Y
+    0xE4, 0xF6,              //       mov A,CPUIO2
+    0xD7, 0x00,              //       mov [recv_ptr]+Y,A
+    0xFC,                    //       inc Y
+    0xE4, 0xF7,              //       mov A,CPUIO3
+    0xDC, 0xDC,              //       dec Y (x2)
+    0xCB, 0xF4,              //       mov CPUIO0,Y
+    0xFC, 0xFC,              //       inc Y (x2)
+    0xD7, 0x00,              //       mov [recv_ptr]+Y,A
+    0xFC,                    //       inc Y
+    0x2F, 0xE0,              //       bra grp
+    0xE5, 0x02, 0x02,        // end:  mov A,drv_counter
+    0x64, 0xF4,              // wend: cmp A,CPUIO0
+    0xD0, 0xFC,              //       bne wend
+    0xC4, 0xF4,              //       mov CPUIO0,A
+    0x5F, 0x06, 0x03,        //       jmp main
+};
+
+TEST(audio_stream_never_waits_on_driver) {
+    static FakeSpc700 spc;
+    spc = FakeSpc700();
+    spc.ram[0x0202] = 0;
+    hal::set_hal(spc);
+    audio::g_audio_initialized = 0;
+
+    const audio::ipl::Block block = {0x0300, k_receive_driver, sizeof(k_receive_driver)};
+    ASSERT_TRUE(audio::init(&block, 1, 0x0300));
+
+    static u8 bank[378];
+    fill_pattern(bank, sizeof(bank), 3);
+    ASSERT_TRUE(audio::stream(0x4000, bank, sizeof(bank)));
+
+    // Called in a loop as from the VBlank wait: every call returns at the
+    // first echo still outstanding, well before the driver's 62-cycle
+    // group loop could finish
+    long start = spc.cycles;
+    long longest = 0;
+    int calls = 0;
+    while (audio::streaming()) {
+        long before = spc.cycles;
+        audio::service();
+        long used = spc.cycles - before;
+        if (used > longest) longest = used;
+        ASSERT_LT(++calls, 10000);
+    }
+    ASSERT_LT(longest, 62);
+
+    // Three chunks of 42 groups at about 65 SPC700 cycles a group:
+    // roughly 47KB a second when the CPU has nothing else to do
+    ASSERT_LT(spc.cycles - start, 3 * 42 * 70);
+    ASSERT_TRUE(std::memcmp(&spc.ram[0x4000], bank, sizeof(bank)) == 0);
+    ASSERT_EQ(spc.ram[0x4000 + sizeof(bank)], 0x55);
+}
+
+// The statements k_receive_driver's RECEIVE handler was assembled from.
+// There is no SPC700 assembler in the tree, so this catches edits to the
+// driver source that the hand-assembled bytes would miss.
+static const char* const k_receive_source[] = {
+    "cmd_receive:",
+    "mov Y, #$00",
+    "@group:",
+    "cmp Y, drv_param",
+    "beq @end",
+    "@wait:",
+    "cmp Y, CPUIO0",
+    "bne @wait",
+    "mov A, CPUIO1",
+    "mov [recv_ptr]+Y, A",
+    "inc Y",
+    "mov A, CPUIO2",
+    "mov [recv_ptr]+Y, A",
+    "inc Y",
+    "mov A, CPUIO3",
+    "dec Y",
+    "dec Y",
+    "mov CPUIO0, Y",
+    "inc Y",
+    "inc Y",
+    "mov [recv_ptr]+Y, A",
+    "inc Y",
+    "bra @group",
+    "@end:",
+    "mov A, drv_counter",
+    "@wait_end:",
+    "cmp A, CPUIO0",
+    "bne @wait_end",
+    "mov CPUIO0, A",
+    "jmp main_loop",
+};
+
+// Next statement of an assembly file: comment stripped, blanks trimmed
+static bool read_statement(std::FILE* f, char* out, int size) {
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        char* end = std::strchr(line, ';');
+        if (end == nullptr) end = line + std::strlen(line);
+        while (end > line && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' ||
+                              end[-1] == '\r')) {
+            end--;
+        }
+        *end = '\0';
+        char* begin = line;
+        while (*begin == ' ' || *begin == '\t') begin++;
+        if (*begin == '\0') continue;
+        std::snprintf(out, static_cast<size_t>(size), "%s", begin);
+        return true;
+    }
+    return false;
+}
+
+TEST(audio_receive_driver_matches_source) {
+    // data/spc700_driver.s, found from this file's path
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s", __FILE__);
+    char* name = std::strrchr(path, '/');
+    name = name ? name + 1 : path;
+    std::snprintf(name, sizeof(path) - static_cast<size_t>(name - path), "../../data/spc700_driver.s");
+    std::FILE* f = std::fopen(path, "r");
+    ASSERT_TRUE(f != nullptr);
+
+    char statement[256];
+    bool found = false;
+    while (read_statement(f, statement, sizeof(statement))) {
+        if (std::strcmp(statement, k_receive_source[0]) == 0) {
+            found = true;
+            break;
+        }
+    }
+    ASSERT_TRUE(found);
+
+    const int count = static_cast<int>(sizeof(k_receive_source) / sizeof(k_receive_source[0]));
+    for (int i = 1; i < count; i++) {
+        ASSERT_TRUE(read_statement(f, statement, sizeof(statement)));
+        if (std::strcmp(statement, k_receive_source[i]) != 0) {
+            std::printf("  driver has '%s', test expects '%s'\n", statement, k_receive_source[i]);
+        }
+        ASSERT_TRUE(std::strcmp(statement, k_receive_source[i]) == 0);
+    }
+    std::fclose(f);
+}
+
+TEST(audio_stream_rejects_short_data) {
+    StreamTestFixture f;
+    u8 two[2] = {1, 2};
+
+    ASSERT_FALSE(audio::stream(0x3000, two, 2));
+    ASSERT_FALSE(audio::streaming());
+}
@@ -0,0 +1,135 @@
+// Unit tests for the broadphase grid and tile-map collision
+#include "test_framework.hpp"
+#include <snes/collision.hpp>
+
+using namespace snes;
+
+using TestGrid = collision::Grid<8, 8, 4, 64>;  // 128x128 px, 16px cells
+
+// Pair collector for for_each_pair
+struct PairLog {
+    u8 a[32];
+    u8 b[32];
+    u8 count;
+
+    bool has(u8 x, u8 y) const {
+        for (u8 i = 0; i < count; i++) {
+            if ((a[i] == x && b[i] == y) || (a[i] == y && b[i] == x)) return true;
+        }
+        return false;
+    }
+};
+
+TEST(rect_overlaps) {
+    Rect r(10, 10, 10, 10);
+    ASSERT_TRUE(r.overlaps(Rect(15, 15, 10, 10)));
+    ASSERT_FALSE(r.overlaps(Rect(20, 10, 5, 5)));  // Touching edge
+    ASSERT_FALSE(r.overlaps(Rect(0, 0, 10, 30)));
+    ASSERT_TRUE(r.overlaps(Rect(0, 0, 11, 11)));
+}
+
+TEST(grid_insert_spans_cells) {
+    TestGrid grid;
+    grid.reset();
+
+    ASSERT_TRUE(grid.insert(0, Rect(4, 4, 8, 8)));     // 1 cell
+    ASSERT_TRUE(grid.insert(1, Rect(12, 12, 8, 8)));   // 4 cells
+    ASSERT_TRUE(grid.insert(2, Rect(-50, 200, 4, 4)));  // Clamped to a corner cell
+    ASSERT_EQ(grid.stats.entries, 6);
+    ASSERT_EQ(grid.head[7 * 8 + 0], 5);
+}
+
+TEST(grid_insert_fails_when_full) {
+    collision::Grid<4, 4, 4, 4> grid;
+    grid.reset();
+
+    ASSERT_TRUE(grid.insert(0, Rect(0, 0, 20, 20)));   // 4 cells
+    ASSERT_FALSE(grid.insert(1, Rect(0, 0, 4, 4)));
+    ASSERT_EQ(grid.entry_count, 4);
+}
+
+TEST(grid_query_deduplicates) {
+    TestGrid grid;
+    grid.reset();
+    grid.insert(0, Rect(12, 12, 8, 8));   // Spans 4 cells
+    grid.insert(1, Rect(100, 100, 8, 8));
+    grid.insert(2, Rect(30, 0, 4, 4));
+
+    u8 out[8];
+    ASSERT_EQ(grid.query(Rect(0, 0, 40, 40), out, 8), 2);
+    ASSERT_TRUE((out[0] == 0 && out[1] == 2) || (out[0] == 2 && out[1] == 0));
+    ASSERT_EQ(grid.query(Rect(50, 50, 10, 10), out, 8), 0);
+    ASSERT_EQ(grid.query(Rect(101, 101, 1, 1), out, 8), 1);
+    ASSERT_EQ(out[0], 1);
+}
+
+TEST(grid_pairs_reported_once) {
+    TestGrid grid;
+    grid.reset();
+    grid.insert(0, Rect(10, 10, 20, 20));   // Spans 4 cells
+    grid.insert(1, Rect(20, 20, 20, 20));   // Overlaps 0 across several cells
+    grid.insert(2, Rect(35, 35, 4, 4));     // Overlaps 1 only
+    grid.insert(3, Rect(90, 90, 4, 4));     // Alone
+
+    PairLog log = {};
+    u16 n = grid.for_each_pair([&log](u8 a, u8 b) {
+        log.a[log.count] = a;
+        log.b[log.count] = b;
+        log.count++;
+    });
+
+    ASSERT_EQ(n, 2);
+    ASSERT_EQ(log.count, 2);
+    ASSERT_TRUE(log.has(0, 1));
+    ASSERT_TRUE(log.has(1, 2));
+    ASSERT_EQ(grid.stats.pairs, 2);
+}
+
+TEST(grid_matches_brute_force) {
+    Rect rects[24];
+    u16 seed = 0x1234;
+    for (u8 i = 0; i < 24; i++) {
+        seed = static_cast<u16>(seed * 25173 + 13849);
+        rects[i] = Rect(static_cast<i16>(seed % 120), static_cast<i16>((seed >> 7) % 120),
+                        static_cast<u16>(4 + seed % 13), static_cast<u16>(4 + (seed >> 4) % 11));
+    }
+
+    // 24 objects of at most 16x14 px in 16px cells use at most 4 entries each
+    collision::Grid<8, 8, 4, 120> big;
+    big.reset();
+    for (u8 i = 0; i < 24; i++) ASSERT_TRUE(big.insert(i, rects[i]));
+
+    u16 expected = 0;
+    for (u8 i = 0; i < 24; i++) {
+        for (u8 j = static_cast<u8>(i + 1); j < 24; j++) {
+            if (rects[i].overlaps(rects[j])) expected++;
+        }
+    }
+    u16 found = big.for_each_pair([&rects](u8 a, u8 b) {
+        ASSERT_TRUE(rects[a].overlaps(rects[b]));
+    });
+    ASSERT_EQ(found, expected);
+    ASSERT_TRUE(big.stats.rect_tests < 24 * 23 / 2);
+}
+
+TEST(tilemap_collision) {
+    // 10x3 tiles: row 0 clear, row 1 has tile 9 solid, row 2 all solid
+    static const u8 bits[] = {
+        0x00, 0x00,
+        0x00, 0x02,
+        0xFF, 0x03,
+    };
+    collision::TileMap map = {bits, 10, 3};
+
+    ASSERT_FALSE(map.solid(0, 0));
+    ASSERT_TRUE(map.solid(9, 1));
+    ASSERT_FALSE(map.solid(8, 1));
+    ASSERT_TRUE(map.solid(4, 2));
+    ASSERT_TRUE(map.solid(-1, 0));   // Outside counts as solid
+    ASSERT_TRUE(map.solid(10, 0));
+
+    ASSERT_FALSE(map.overlaps(Rect(0, 0, 16, 16)));
+    ASSERT_TRUE(map.overlaps(Rect(0, 10, 16, 8)));     // Reaches row 2
+    ASSERT_TRUE(map.overlaps(Rect(70, 8, 4, 4)));      // Tile (9, 1)
+    ASSERT_FALSE(map.overlaps(Rect(64, 8, 8, 8)));     // Tile (8, 1) only
+}
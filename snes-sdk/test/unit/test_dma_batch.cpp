@@ -0,0 +1,132 @@
+// Unit tests for batched multi-channel DMA
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/dma.hpp>
+
+using namespace snes;
+using namespace snes::dma;
+
+// Helper to set up fake HAL and a free channel pool
+struct DmaBatchTestFixture {
+    snes::testing::FakeRegisterAccess fake;
+    Batch batch;
+
+    DmaBatchTestFixture() {
+        fake.clear();
+        hal::set_hal(fake);
+        g_channels.reset();
+        batch.begin();
+    }
+};
+
+static u8 g_batch_test_data[1024];
+
+TEST(dma_batch_single_mdmaen_write) {
+    DmaBatchTestFixture f;
+
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x1000, 512));
+    ASSERT_TRUE(f.batch.add_cgram(g_batch_test_data, 0, 32));
+    ASSERT_TRUE(f.batch.add_oam(g_batch_test_data));
+
+    // Nothing is programmed until kick
+    ASSERT_EQ(f.fake.write_count, 0);
+
+    ASSERT_EQ(f.batch.kick(), 512 + 32 + 544);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_EQ(f.fake.last_write(reg::MDMAEN::address), 0x07);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::DEST::address), 0x18);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<1>::DEST::address), 0x22);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<2>::DEST::address), 0x04);
+}
+
+TEST(dma_batch_skips_hdma_channels) {
+    DmaBatchTestFixture f;
+    g_channels.claim_hdma(1);
+    f.batch.begin();
+
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x0000, 64));
+    ASSERT_TRUE(f.batch.add_cgram(g_batch_test_data, 0, 32));
+    f.batch.kick();
+
+    ASSERT_EQ(f.fake.last_write(reg::MDMAEN::address), 0x05);
+    ASSERT_FALSE(f.fake.wrote_to(reg::DMA<1>::DEST::address));
+}
+
+TEST(dma_batch_port_continuation) {
+    DmaBatchTestFixture f;
+
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x2000, 256));
+
+    // Must continue at 0x2000 + 128 words
+    ASSERT_FALSE(f.batch.add_vram(g_batch_test_data, 0x3000, 64));
+    ASSERT_TRUE(f.batch.add_fill_vram(0x2080, reinterpret_cast<const u16*>(g_batch_test_data), 16));
+
+    // VRAM address is only set once, at kick; a zero fill is a single pass
+    ASSERT_EQ(f.batch.kick(), 256 + 32);
+    ASSERT_EQ(f.fake.count_writes(reg::VMADDH::address), 1);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<1>::CTRL::address), mode::WORD_TO_TWO | addr::FIXED);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+}
+
+TEST(dma_batch_sets_addresses_at_kick) {
+    DmaBatchTestFixture f;
+
+    ASSERT_TRUE(f.batch.add_cgram(g_batch_test_data, 16, 32));
+
+    // Something else uses CGADD between add() and kick()
+    hal::write8(reg::CGADD::address, 0);
+    f.batch.kick();
+
+    ASSERT_EQ(f.fake.last_write(reg::CGADD::address), 16);
+}
+
+TEST(dma_batch_fill_with_two_bytes_splits_kick) {
+    DmaBatchTestFixture f;
+    static const u16 value = 0x2001;
+
+    ASSERT_TRUE(f.batch.add_cgram(g_batch_test_data, 0, 32));
+    ASSERT_TRUE(f.batch.add_fill_vram(0x4000, &value, 64));
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x4040, 64));
+    ASSERT_EQ(f.batch.kick(), 32 + 128 + 64);
+
+    // CGRAM alone, then low and high passes of the fill, then the VRAM copy
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 4);
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<1>::DEST::address, 0x18));
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<1>::DEST::address, 0x19));
+    ASSERT_TRUE(f.fake.wrote(reg::VMAIN::address, 0x00));
+    ASSERT_EQ(f.fake.last_write(reg::DMA<1>::CTRL::address), mode::BYTE_TO_ONE | addr::FIXED);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<1>::SIZEL::address), 64);
+    ASSERT_EQ(f.fake.last_write(reg::MDMAEN::address), 0x04);
+
+    // The copy continues where the fill left VMADD; it is not re-addressed
+    ASSERT_EQ(f.fake.count_writes(reg::VMADDH::address), 2);  // One per fill pass
+}
+
+TEST(dma_batch_odd_size_closes_port) {
+    DmaBatchTestFixture f;
+
+    ASSERT_TRUE(f.batch.add_cgram(g_batch_test_data, 0, 3));
+    ASSERT_FALSE(f.batch.add_cgram(g_batch_test_data, 1, 2));
+}
+
+TEST(dma_batch_runs_out_of_channels) {
+    DmaBatchTestFixture f;
+    f.batch.begin(0x03);
+
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x0000, 2));
+    ASSERT_TRUE(f.batch.add_vram(g_batch_test_data, 0x0001, 2));
+    ASSERT_FALSE(f.batch.add_vram(g_batch_test_data, 0x0002, 2));
+    ASSERT_FALSE(f.batch.add_cgram(g_batch_test_data, 0, 0));
+    ASSERT_EQ(f.batch.kick(), 4);
+}
+
+TEST(dma_batch_empty_kick_is_noop) {
+    DmaBatchTestFixture f;
+
+    ASSERT_TRUE(f.batch.empty());
+    ASSERT_EQ(f.batch.kick(), 0);
+    ASSERT_FALSE(f.fake.wrote_to(reg::MDMAEN::address));
+}
@@ -0,0 +1,113 @@
+// Unit tests for the DMA/HDMA channel allocator
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/dma.hpp>
+#include <snes/ppu.hpp>
+#include <snes/snes.hpp>
+
+using namespace snes;
+using namespace snes::dma;
+
+using TestLayout = ChannelLayout<0xC0>;
+static_assert(TestLayout::hdma<0> == 6, "first HDMA channel");
+static_assert(TestLayout::hdma<1> == 7, "second HDMA channel");
+static_assert(TestLayout::gpdma<0> == 0, "first GPDMA channel");
+static_assert(TestLayout::gpdma<5> == 5, "last GPDMA channel");
+static_assert(TestLayout::is_gpdma<3>, "channel 3 is GPDMA");
+static_assert(!TestLayout::is_gpdma<7>, "channel 7 is HDMA");
+
+TEST(dma_channels_hdma_claims_from_top) {
+    ChannelAllocator a;
+    a.reset();
+
+    ASSERT_EQ(a.claim_hdma(), 7);
+    ASSERT_EQ(a.claim_hdma(), 6);
+    ASSERT_EQ(a.hdma_mask, 0xC0);
+    ASSERT_EQ(a.gpdma_channel(), 0);
+    ASSERT_TRUE(a.is_hdma(6));
+    ASSERT_FALSE(a.is_hdma(5));
+}
+
+TEST(dma_channels_keeps_one_for_gpdma) {
+    ChannelAllocator a;
+    a.reset();
+
+    for (int i = 0; i < 7; i++) {
+        ASSERT_NE(a.claim_hdma(), NO_CHANNEL);
+    }
+    ASSERT_EQ(a.claim_hdma(), NO_CHANNEL);
+    ASSERT_EQ(a.gpdma_channel(), 0);
+    ASSERT_EQ(a.gpdma_channel(1), NO_CHANNEL);
+    ASSERT_FALSE(a.claim_hdma(0));
+}
+
+TEST(dma_channels_claim_specific_and_release) {
+    ChannelAllocator a;
+    a.reset();
+
+    ASSERT_TRUE(a.claim_hdma(1));
+    ASSERT_FALSE(a.claim_hdma(1));
+    ASSERT_FALSE(a.claim_hdma(8));
+    ASSERT_EQ(a.gpdma_channel(), 0);
+    ASSERT_EQ(a.gpdma_channel(1), 2);
+
+    a.release_hdma(1);
+    ASSERT_EQ(a.gpdma_channel(1), 1);
+    ASSERT_EQ(a.hdma_mask, 0);
+}
+
+TEST(dma_channels_channel_0_stays_gpdma) {
+    ChannelAllocator a;
+    a.reset();
+
+    // The GPDMA helpers default to channel 0, so HDMA may never take it
+    ASSERT_FALSE(a.claim_hdma(GPDMA_CHANNEL));
+    ASSERT_EQ(a.hdma_mask, 0);
+
+    for (u8 ch = 7; ch > 0; ch--) ASSERT_TRUE(a.claim_hdma(ch));
+    ASSERT_EQ(a.claim_hdma(), NO_CHANNEL);
+    ASSERT_EQ(a.gpdma_mask(), 0x01);
+}
+
+TEST(dma_channels_init_clears_garbage_mask) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    // Uninitialized BSS: every channel looks claimed by HDMA
+    g_channels.hdma_mask = 0xFF;
+
+    snes::init();
+    ASSERT_EQ(g_channels.hdma_mask, 0);
+    ASSERT_EQ(g_channels.gpdma_channel(), GPDMA_CHANNEL);
+    ASSERT_EQ(g_channels.claim_hdma(), 7);
+    g_channels.reset();
+}
+
+TEST(dma_channels_runtime_setup_and_enable) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+    g_channels.reset();
+
+    static const u8 table[] = {1, 0x0F, 0};
+    u8 ch = g_channels.claim_hdma();
+    hdma_setup_direct(ch, 0x00, table);
+    hdma_enable_claimed();
+
+    ASSERT_EQ(fake.last_write(reg::DMA<7>::DEST::address), 0x00);
+    ASSERT_EQ(fake.last_write(reg::DMA<7>::CTRL::address), 0x00);
+    ASSERT_EQ(fake.last_write(reg::HDMAEN::address), 0x80);
+}
+
+TEST(dma_channels_sprites_upload_channel) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    ppu::sprites_upload<2>(true);
+
+    ASSERT_EQ(fake.last_write(reg::DMA<2>::DEST::address), 0x04);
+    ASSERT_EQ(fake.last_write(reg::MDMAEN::address), 0x04);
+    ASSERT_FALSE(fake.wrote_to(reg::DMA<0>::DEST::address));
+}
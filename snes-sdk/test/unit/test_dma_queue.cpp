@@ -0,0 +1,205 @@
+// Unit tests for the VBlank DMA transfer queue
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/dma.hpp>
+#include <snes/vblank.hpp>
+
+using namespace snes;
+using namespace snes::dma;
+
+// Helper to set up fake HAL and an empty queue
+struct DmaQueueTestFixture {
+    snes::testing::FakeRegisterAccess fake;
+
+    explicit DmaQueueTestFixture(u16 budget = DEFAULT_FRAME_BUDGET) {
+        fake.clear();
+        hal::set_hal(fake);
+        vblank::clear_hooks();
+        g_queue.reset(budget);
+    }
+};
+
+static u8 g_dma_test_data[2048];
+
+TEST(dma_queue_starts_empty) {
+    DmaQueueTestFixture f;
+
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(g_queue.pending_bytes(), 0);
+    ASSERT_EQ(flush_queue(), 0);
+    ASSERT_FALSE(f.fake.wrote_to(reg::MDMAEN::address));
+}
+
+TEST(dma_queue_defers_until_flush) {
+    DmaQueueTestFixture f;
+
+    ASSERT_TRUE(queue_vram(g_dma_test_data, 0x4000, 256));
+
+    // Nothing touches the hardware until flush
+    ASSERT_EQ(f.fake.write_count, 0);
+    ASSERT_EQ(g_queue.pending_bytes(), 256);
+
+    ASSERT_EQ(flush_queue(), 256);
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_EQ(f.fake.last_write(reg::VMADDL::address), 0x00);
+    ASSERT_EQ(f.fake.last_write(reg::VMADDH::address), 0x40);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::SIZEL::address), 0x00);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::SIZEH::address), 0x01);
+}
+
+TEST(dma_queue_flushes_in_order) {
+    DmaQueueTestFixture f;
+
+    queue_cgram(g_dma_test_data, 16, 32);
+    queue_oam(g_dma_test_data, 544);
+
+    ASSERT_EQ(flush_queue(), 576);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_EQ(f.fake.last_write(reg::CGADD::address), 16);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::DEST::address), 0x04);  // OAMDATA last
+}
+
+TEST(dma_queue_budget_spills_to_next_frame) {
+    DmaQueueTestFixture f(1500);
+
+    queue_vram(g_dma_test_data, 0x1000, 1000);
+    queue_vram(g_dma_test_data, 0x2000, 1000);
+
+    // Frame 1: first transfer plus 500 bytes of the second
+    ASSERT_EQ(flush_queue(), 1500);
+    ASSERT_EQ(g_queue.count(), 1);
+    ASSERT_EQ(g_queue.pending_bytes(), 500);
+
+    // Remainder resumes 250 words further into VRAM and 500 bytes into the source
+    const Transfer& rest = g_queue.front();
+    ASSERT_EQ(rest.dest, 0x2000 + 250);
+    ASSERT_TRUE(rest.src == g_dma_test_data + 500);
+
+    // Frame 2: remainder
+    f.fake.clear();
+    ASSERT_EQ(flush_queue(), 500);
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+}
+
+TEST(dma_queue_split_is_even) {
+    DmaQueueTestFixture f(101);
+
+    queue_vram(g_dma_test_data, 0x0000, 200);
+
+    ASSERT_EQ(flush_queue(), 100);
+    ASSERT_EQ(g_queue.front().dest, 50);
+}
+
+TEST(dma_queue_fill_keeps_source) {
+    DmaQueueTestFixture f(64);
+    static const u16 zero = 0;
+
+    queue_fill_vram(0x1000, &zero, 64);  // 128 bytes
+
+    ASSERT_EQ(flush_queue(), 64);
+    ASSERT_TRUE(g_queue.front().src == reinterpret_cast<const u8*>(&zero));
+    ASSERT_EQ(g_queue.front().dest, 0x1000 + 32);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::CTRL::address),
+              mode::WORD_TO_TWO | addr::FIXED | dir::TO_PPU);
+}
+
+TEST(dma_queue_fill_sends_both_bytes) {
+    DmaQueueTestFixture f;
+    static const u16 value = 0x1234;
+
+    queue_fill_vram(0x1000, &value, 32);
+
+    // Low byte pass to VMDATAL, then high byte pass to VMDATAH
+    ASSERT_EQ(flush_queue(), 64);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<0>::DEST::address, 0x18));
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::DEST::address), 0x19);
+    ASSERT_EQ(f.fake.last_write(reg::VMAIN::address), 0x80);
+    ASSERT_EQ(f.fake.last_write(reg::DMA<0>::SIZEL::address), 32);
+}
+
+TEST(dma_queue_rejects_when_full) {
+    DmaQueueTestFixture f;
+
+    for (u8 i = 0; i < QUEUE_CAPACITY; i++) {
+        ASSERT_TRUE(queue_vram(g_dma_test_data, 0, 2));
+    }
+    ASSERT_TRUE(g_queue.full());
+    ASSERT_FALSE(queue_vram(g_dma_test_data, 0, 2));
+    ASSERT_FALSE(g_queue.push(target::VRAM, g_dma_test_data, 0, 0));
+}
+
+TEST(dma_queue_wraps_indices) {
+    DmaQueueTestFixture f;
+
+    // Run head and tail past 255 so the free-running indices wrap
+    for (u16 i = 0; i < 300; i++) {
+        ASSERT_TRUE(queue_vram(g_dma_test_data, 0, 2));
+        if (i & 1) ASSERT_EQ(flush_queue(), 4);
+    }
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(g_queue.count(), 0);
+}
+
+TEST(dma_queue_flush_between_fill_and_publish) {
+    DmaQueueTestFixture f;
+
+    queue_vram(g_dma_test_data, 0x1000, 64);
+
+    // Main code has filled the next slot but not yet moved tail when NMI fires
+    Transfer& slot = g_queue.entries[g_queue.tail & (QUEUE_CAPACITY - 1)];
+    slot.src = g_dma_test_data;
+    slot.dest = 0x2000;
+    slot.size = 128;
+    slot.target = target::VRAM;
+
+    // The flush sends only the published transfer and leaves the slot alone
+    ASSERT_EQ(flush_queue(), 64);
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(slot.size, 128);
+
+    // Publishing afterwards is not lost to the flush's update of head
+    g_queue.tail = static_cast<u8>(g_queue.tail + 1);
+    ASSERT_EQ(g_queue.count(), 1);
+
+    f.fake.clear();
+    ASSERT_EQ(flush_queue(), 128);
+    ASSERT_EQ(f.fake.last_write(reg::VMADDH::address), 0x20);
+    ASSERT_TRUE(g_queue.empty());
+}
+
+TEST(dma_queue_install_flushes_on_nmi) {
+    DmaQueueTestFixture f;
+
+    ASSERT_TRUE(install_queue(1024));
+    queue_vram(g_dma_test_data, 0x3000, 2048);
+
+    vblank::dispatch();
+    ASSERT_EQ(g_queue.pending_bytes(), 1024);
+
+    vblank::dispatch();
+    ASSERT_TRUE(g_queue.empty());
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+
+    uninstall_queue();
+}
+
+TEST(vblank_hooks_add_remove) {
+    DmaQueueTestFixture f;
+    u16 start = vblank::frame_count();
+
+    ASSERT_TRUE(vblank::add_hook(dma::detail::flush_queue_nmi));
+    ASSERT_TRUE(vblank::add_hook(dma::detail::flush_queue_nmi));  // Duplicate is a no-op
+    ASSERT_TRUE(vblank::g_hooks[1] == nullptr);
+
+    vblank::remove_hook(dma::detail::flush_queue_nmi);
+    ASSERT_TRUE(vblank::g_hooks[0] == nullptr);
+
+    vblank::dispatch();
+    ASSERT_EQ(vblank::frame_count(), static_cast<u16>(start + 1));
+}
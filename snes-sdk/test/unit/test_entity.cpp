@@ -0,0 +1,129 @@
+// Unit tests for the structure-of-arrays entity pool
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/entity.hpp>
+
+using namespace snes;
+
+// Helper to set up fake HAL and an empty sprite pool
+struct EntityTestFixture {
+    snes::testing::FakeRegisterAccess fake;
+    ppu::SpritePool sprites;
+
+    EntityTestFixture() {
+        fake.clear();
+        hal::set_hal(fake);
+        sprites.reset();
+        ppu::oam_dirty.clear();
+    }
+};
+
+static entity::Coord px(int pixels) { return entity::Coord::from_int(pixels); }
+
+TEST(entity_spawn_until_full) {
+    entity::Pool<4> pool;
+    pool.reset();
+
+    for (u8 i = 0; i < 4; i++) {
+        ASSERT_EQ(pool.spawn(px(i), px(0), px(0), px(0), 1), i);
+    }
+    ASSERT_TRUE(pool.full());
+    ASSERT_EQ(pool.spawn(px(0), px(0), px(0), px(0), 1), entity::NO_ENTITY);
+    ASSERT_EQ(pool.count, 4);
+}
+
+TEST(entity_kill_reuses_slot_and_keeps_dense_list) {
+    entity::Pool<8> pool;
+    pool.reset();
+    for (u8 i = 0; i < 5; i++) pool.spawn(px(i), px(0), px(0), px(0), 1);
+
+    pool.kill(1);
+    pool.kill(1);  // Already free: ignored
+    ASSERT_EQ(pool.count, 4);
+    ASSERT_FALSE(pool.alive(1));
+
+    // Dense list still names each live id exactly once
+    int seen = 0;
+    for (u8 i = 0; i < pool.count; i++) {
+        ASSERT_TRUE(pool.alive(pool.active[i]));
+        ASSERT_EQ(pool.active_index[pool.active[i]], i);
+        seen |= 1 << pool.active[i];
+    }
+    ASSERT_EQ(seen, 0x1D);
+
+    ASSERT_EQ(pool.spawn(px(9), px(9), px(0), px(0), 2), 1);
+}
+
+TEST(entity_integrate_moves_by_velocity) {
+    entity::Pool<4> pool;
+    pool.reset();
+    u8 id = pool.spawn(px(10), px(20), entity::Coord::from_float(1.5f), px(-2), 1);
+
+    pool.integrate();
+    pool.integrate();
+
+    ASSERT_EQ(entity::Coord(pool.x[id]).to_int(), 13);
+    ASSERT_EQ(entity::Coord(pool.y[id]).to_int(), 16);
+}
+
+TEST(entity_cull_kills_outside_bounds) {
+    entity::Pool<8> pool;
+    pool.reset();
+    pool.spawn(px(10), px(10), px(0), px(0), 1);
+    pool.spawn(px(-5), px(10), px(0), px(0), 1);
+    pool.spawn(px(100), px(300), px(0), px(0), 1);
+    pool.spawn(px(255), px(0), px(0), px(0), 1);
+
+    ASSERT_EQ(pool.cull(Rect(0, 0, 256, 224)), 2);
+    ASSERT_TRUE(pool.alive(0));
+    ASSERT_FALSE(pool.alive(1));
+    ASSERT_FALSE(pool.alive(2));
+    ASSERT_TRUE(pool.alive(3));
+}
+
+TEST(entity_draw_writes_oam_shadow) {
+    EntityTestFixture f;
+    entity::Pool<8> pool;
+    pool.reset();
+
+    u8 a = pool.spawn(px(120), px(50), px(0), px(0), 1);
+    pool.tile[a] = 0x42;
+    pool.attr[a] = 0x30;
+    u8 b = pool.spawn(px(10), px(60), px(0), px(0), 1);
+    pool.flags[b] = entity::flag::LARGE;
+    u8 c = pool.spawn(px(500), px(60), px(0), px(0), 1);  // Off-screen
+    (void)c;
+    u8 d = pool.spawn(px(40), px(40), px(0), px(0), 1);
+    pool.flags[d] = entity::flag::HIDDEN;
+
+    f.sprites.begin_frame();
+    ASSERT_EQ(pool.draw(f.sprites, 20, 0), 2);
+    f.sprites.end_frame();
+
+    ASSERT_EQ(ppu::oam_low[0].x_low, 100);
+    ASSERT_EQ(ppu::oam_low[0].y, 50);
+    ASSERT_EQ(ppu::oam_low[0].tile, 0x42);
+    ASSERT_EQ(ppu::oam_low[0].attr, 0x30);
+
+    // x = -10: low byte 0xF6 plus the X high bit; large size
+    ASSERT_EQ(ppu::oam_low[1].x_low, 0xF6);
+    ASSERT_EQ(ppu::oam_high[0] & 0x0C, 0x0C);
+    ASSERT_EQ(ppu::oam_high[0] & 0x03, 0x00);
+
+    ASSERT_EQ(ppu::oam_dirty.low_first, 0);
+    ASSERT_TRUE(ppu::oam_dirty.low_last >= 1);
+}
+
+TEST(entity_draw_stops_when_sprites_run_out) {
+    EntityTestFixture f;
+    entity::Pool<200> pool;
+    pool.reset();
+    for (u8 i = 0; i < 200; i++) pool.spawn(px(i), px(100), px(0), px(0), 1);
+
+    f.sprites.begin_frame();
+    ASSERT_EQ(pool.draw(f.sprites, 0, 0), 128);
+    ASSERT_EQ(f.sprites.alloc(), ppu::NO_SPRITE);
+}
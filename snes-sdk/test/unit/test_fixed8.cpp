@@ -152,3 +152,107 @@ TEST(rect_bounds) {
     ASSERT_EQ(r.top(), 20);
     ASSERT_EQ(r.bottom(), 60);
 }
+
+// Fixed<I, F, Storage> formats
+
+TEST(fixed_aliases_keep_layout) {
+    ASSERT_EQ(sizeof(Fixed8), 2u);
+    ASSERT_EQ(sizeof(Fixed12), 2u);
+    ASSERT_EQ(Fixed12::from_int(1).raw, 4096);
+    ASSERT_EQ((Fixed12::from_float(1.5f) * Fixed12::from_float(0.5f)).raw, 3072);
+    ASSERT_EQ((Fixed12::from_int(3) / Fixed12::from_int(2)).raw, 6144);
+}
+
+TEST(fixed_cast_between_formats) {
+    constexpr Fixed12 half = Fixed12::from_float(0.5f);
+    static_assert(fixed_cast<Fixed8>(half).raw == 128, "4.12 -> 8.8 at compile time");
+
+    ASSERT_EQ(fixed_cast<Fixed12>(Fixed8::from_float(-1.25f)).raw, -5120);
+    ASSERT_EQ((fixed_cast<Fixed<16, 16, i32>>(Fixed8(-384))).raw, -98304);
+
+    // 8.8 value 100.0 does not fit 4.12
+    ASSERT_EQ(fixed_cast<Fixed12>(Fixed8::from_int(100)).raw, static_cast<i16>(100 << 12));
+    ASSERT_EQ(saturate_cast<Fixed12>(Fixed8::from_int(100)).raw, 32767);
+    ASSERT_EQ(saturate_cast<Fixed12>(Fixed8::from_int(-100)).raw, -32768);
+}
+
+TEST(fixed_saturating_arithmetic) {
+    auto big = Fixed8::from_int(100);
+
+    ASSERT_EQ(big.add_sat(big), Fixed8::max());
+    ASSERT_EQ((-big).sub_sat(big), Fixed8::min());
+    ASSERT_EQ(big.mul_sat(big), Fixed8::max());
+    ASSERT_EQ(Fixed8::from_int(2).add_sat(Fixed8::from_int(3)).to_int(), 5);
+
+    // Plain operators wrap
+    ASSERT_EQ((big + big).raw, static_cast<i16>(200 * 256));
+}
+
+TEST(fixed_cheap_scaling) {
+    auto v = Fixed8::from_float(1.5f);
+
+    ASSERT_EQ((v * 3).raw, 1152);
+    ASSERT_EQ((v / 3).raw, 128);
+    ASSERT_EQ((v << 2).raw, 1536);
+    ASSERT_EQ((v >> 1).raw, 192);
+    ASSERT_EQ((Fixed8(-3) >> 1).raw, -2);
+    ASSERT_EQ((Fixed8(-384) << 2).raw, -1536);
+    ASSERT_EQ((Fixed8(0x4000) << 1).raw, static_cast<i16>(0x8000));  // Wraps
+}
+
+static_assert((Fixed8(-3) << 3).raw == -24, "<< is usable at compile time");
+static_assert(sizeof(Fixed8().frac()) == 1, "8.8 frac() stays a byte");
+static_assert(sizeof(Fixed12().frac()) == 2, "4.12 frac() needs 16 bits");
+
+TEST(fixed_mixed_format_multiply) {
+    // 8.8 speed times a 4.12 direction stays 8.8
+    auto speed = Fixed8::from_int(3);
+    auto dir = Fixed12::from_float(-0.5f);
+    ASSERT_EQ(speed.mul(dir).raw, -384);
+
+    // 8-bit storage
+    using Fixed4 = Fixed<4, 4, i8>;
+    auto a = Fixed4::from_float(1.5f);
+    ASSERT_EQ((a * a).raw, 36);
+    ASSERT_EQ(a.mul_sat(Fixed4::from_int(7)), Fixed4::max());
+}
+
+static_assert(sizeof(Fixed8().to_int()) == sizeof(int), "8.8 to_int() stays an int");
+
+TEST(fixed_i32_arithmetic_matches_wide) {
+    using Fixed16 = Fixed<16, 16, i32>;
+    const long long values[] = {0, 1, -1, 65536, -65536, 98304, -98304, 12345678,
+                                -87654321, 2147483647LL, -2147483647LL - 1};
+    const long long lo = -2147483647LL - 1;
+    const long long hi = 2147483647LL;
+
+    for (long long a : values) {
+        for (long long b : values) {
+            Fixed16 x(static_cast<i32>(a));
+            Fixed16 y(static_cast<i32>(b));
+
+            // Reference: full 64-bit math, wrapped or clamped to 32 bits
+            long long p = (a * b) >> 16;
+            ASSERT_EQ((x * y).raw, static_cast<i32>(static_cast<int>(p)));
+            ASSERT_EQ(x.mul_sat(y).raw, static_cast<i32>(p > hi ? hi : p < lo ? lo : p));
+
+            long long s = a + b;
+            long long d = a - b;
+            ASSERT_EQ(x.add_sat(y).raw, static_cast<i32>(s > hi ? hi : s < lo ? lo : s));
+            ASSERT_EQ(x.sub_sat(y).raw, static_cast<i32>(d > hi ? hi : d < lo ? lo : d));
+
+            if (b != 0 && !(a == lo && b == -1)) {
+                long long q = (a * 65536) / b;
+                ASSERT_EQ((x / y).raw, static_cast<i32>(static_cast<int>(q)));
+            }
+        }
+    }
+
+    ASSERT_EQ(Fixed16::from_int(-3).raw, -196608);
+    ASSERT_EQ(Fixed16::from_int(-3).to_int(), -3);
+    ASSERT_EQ((Fixed16::from_float(1.5f).mul(Fixed8::from_float(-2.0f))).raw, -196608);
+    ASSERT_EQ((Fixed8::from_float(1.5f).mul(Fixed16::from_float(-2.0f))).raw, -768);
+}
+
+static_assert((Fixed<16, 16, i32>::from_int(6) / Fixed<16, 16, i32>::from_int(4)).raw == 98304,
+              "i32 divide is usable at compile time");
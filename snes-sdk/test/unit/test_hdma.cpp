@@ -0,0 +1,141 @@
+// Unit tests for the HDMA table builder
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/hdma.hpp>
+
+using namespace snes;
+using namespace snes::hdma;
+
+// Compile-time table: 32 intensity steps over 224 lines, 7 lines each
+constexpr auto kTestGradient = [] {
+    Table<1, 128> t{};
+    t.reset();
+    gradient(t, 31, 0, 224, coldata::BLUE);
+    return t;
+}();
+static_assert(kTestGradient.lines() == 224, "gradient covers the screen");
+static_assert(kTestGradient.size == 32 * 2, "one entry per intensity");
+static_assert(kTestGradient.bytes[0] == 7, "first entry holds 7 lines");
+static_assert(kTestGradient.bytes[1] == (coldata::BLUE | 31), "starts at full blue");
+static_assert(kTestGradient.bytes[kTestGradient.size] == 0, "terminated");
+
+TEST(hdma_hold_splits_long_runs) {
+    Table<2, 16> t;
+    t.reset();
+
+    ASSERT_TRUE(t.hold(200, 0x1234));
+
+    ASSERT_EQ(t.size, 6);
+    ASSERT_EQ(t.bytes[0], 127);
+    ASSERT_EQ(t.bytes[1], 0x34);
+    ASSERT_EQ(t.bytes[2], 0x12);
+    ASSERT_EQ(t.bytes[3], 73);
+    ASSERT_EQ(t.bytes[6], 0);
+    ASSERT_EQ(t.lines(), 200);
+}
+
+TEST(hdma_line_shares_repeat_header) {
+    Table<2, 32> t;
+    t.reset();
+
+    window_line(t, 10, 20);
+    window_line(t, 9, 21);
+    window_line(t, 8, 22);
+
+    ASSERT_EQ(t.bytes[0], 0x83);
+    ASSERT_EQ(t.bytes[1], 10);
+    ASSERT_EQ(t.bytes[2], 20);
+    ASSERT_EQ(t.bytes[5], 8);
+    ASSERT_EQ(t.size, 7);
+    ASSERT_EQ(t.lines(), 3);
+
+    // A hold closes the run
+    t.hold(1, 0);
+    window_line(t, 0, 0);
+    ASSERT_EQ(t.bytes[10], 0x81);
+    ASSERT_EQ(t.lines(), 5);
+}
+
+TEST(hdma_reserve_lines_fills_in_place) {
+    Table<2, 16> t;
+    t.reset();
+
+    u8* data = t.reserve_lines(3);
+    ASSERT_TRUE(data == &t.bytes[1]);
+    data[0] = 0x11;
+    data[5] = 0x66;
+
+    ASSERT_EQ(t.bytes[0], 0x83);
+    ASSERT_EQ(t.size, 7);
+    ASSERT_EQ(t.bytes[7], 0);
+    ASSERT_EQ(t.lines(), 3);
+
+    // The reserved run stays closed to line()
+    window_line(t, 1, 2);
+    ASSERT_EQ(t.bytes[7], 0x81);
+    ASSERT_EQ(t.lines(), 4);
+
+    ASSERT_TRUE(t.reserve_lines(4) == nullptr);
+    ASSERT_TRUE(t.reserve_lines(0) == nullptr);
+}
+
+TEST(hdma_table_full) {
+    Table<1, 6> t;
+    t.reset();
+
+    ASSERT_TRUE(t.hold(1, 1));
+    ASSERT_TRUE(t.hold(1, 2));
+    ASSERT_FALSE(t.hold(1, 3));
+    ASSERT_EQ(t.size, 4);
+    ASSERT_EQ(t.bytes[4], 0);
+}
+
+TEST(hdma_parallax_and_fade) {
+    Table<2, 32> scroll;
+    scroll.reset();
+    const Band bands[] = {{64, 0}, {32, 0x0100}, {128, 0x0200}};
+    ASSERT_TRUE(parallax(scroll, bands, 3));
+    ASSERT_EQ(scroll.lines(), 224);
+    ASSERT_EQ(scroll.bytes[3], 32);
+    ASSERT_EQ(scroll.bytes[5], 0x01);
+
+    Table<1, 64> f;
+    f.reset();
+    ASSERT_TRUE(fade(f, 0, 15, 100));
+    ASSERT_EQ(f.lines(), 100);
+    ASSERT_EQ(f.bytes[1], 0);
+    ASSERT_EQ(f.bytes[f.size - 1], 15);
+}
+
+TEST(hdma_double_buffer_commit) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    static DoubleBuffer<Table<1, 16>> db;
+    db.reset();
+
+    ASSERT_FALSE(db.commit(6));
+    ASSERT_FALSE(fake.wrote_to(reg::DMA<6>::SRCL::address));
+
+    Table<1, 16>& back = db.back();
+    back.hold(10, 0x0F);
+    db.present();
+    ASSERT_TRUE(db.commit(6));
+
+    ASSERT_TRUE(&db.active() == &back);
+    ASSERT_EQ(fake.count_writes16(reg::DMA<6>::SRCL::address), 1);
+    ASSERT_FALSE(db.pending);
+}
+
+TEST(hdma_attach_programs_channel) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    attach(7, hdma::target::BG2HOFS, kTestGradient);
+
+    ASSERT_EQ(fake.last_write(reg::DMA<7>::DEST::address), 0x0F);
+    ASSERT_EQ(fake.last_write(reg::DMA<7>::CTRL::address), 0x02);
+}
@@ -5,6 +5,7 @@
 #include "test_framework.hpp"
 #include "fake_hal.hpp"
 #include <snes/input.hpp>
+#include <snes/snes.hpp>
 
 using namespace snes;
 using namespace snes::input;
@@ -220,3 +221,209 @@ TEST(joypad_different_ids) {
     ASSERT_FALSE(pad1.held(Button::A));
     ASSERT_TRUE(pad1.held(Button::B));
 }
+
+// NMI latch tests
+
+// Run one NMI with the given pad states
+static void latch_frame(JoypadTestFixture& f, u16 pad0, u16 pad1) {
+    f.set_joypad_state(0, pad0);
+    f.set_joypad_state(1, pad1);
+    vblank::dispatch();
+}
+
+struct LatchTestFixture : JoypadTestFixture {
+    LatchTestFixture() {
+        vblank::clear_hooks();
+        g_latch.count = 0;
+        install_latch();
+    }
+
+    ~LatchTestFixture() {
+        uninstall_latch();
+        vblank::clear_hooks();
+    }
+};
+
+TEST(joypad_latch_snapshots_both_pads) {
+    LatchTestFixture f;
+
+    latch_frame(f, 0x0080, 0x8000);
+    latch_frame(f, 0x0000, 0x4000);
+
+    ASSERT_EQ(g_latch.count, 2);
+    ASSERT_EQ(g_latch.history(0, 0), 0x0000);
+    ASSERT_EQ(g_latch.history(0, 1), 0x0080);
+    ASSERT_EQ(g_latch.history(1, 0), 0x4000);
+    ASSERT_EQ(g_latch.history(1, 1), 0x8000);
+}
+
+TEST(joypad_reads_latch_not_hardware) {
+    LatchTestFixture f;
+    Joypad pad(0);
+
+    latch_frame(f, 0x0080, 0);
+    f.fake.clear();
+    f.set_joypad_state(0, 0x0040);  // Hardware changed after the NMI
+
+    pad.update();
+    ASSERT_TRUE(pad.held(Button::A));
+    ASSERT_FALSE(pad.held(Button::X));
+    ASSERT_TRUE(pad.pressed(Button::A));
+    ASSERT_EQ(pad.frames_since_update(), 0);
+
+    // No new frame: state holds, edges clear
+    pad.update();
+    ASSERT_TRUE(pad.held(Button::A));
+    ASSERT_FALSE(pad.pressed(Button::A));
+}
+
+TEST(joypad_latch_keeps_taps_during_lag_frames) {
+    LatchTestFixture f;
+    Joypad pad(0);
+
+    latch_frame(f, 0x0000, 0);
+    pad.update();
+
+    // Game lags three frames; B is tapped in the middle one
+    latch_frame(f, 0x0000, 0);
+    latch_frame(f, 0x8000, 0);
+    latch_frame(f, 0x0000, 0);
+    ASSERT_EQ(pad.frames_since_update(), 3);
+
+    pad.update();
+    ASSERT_FALSE(pad.held(Button::B));
+    ASSERT_TRUE(pad.pressed(Button::B));
+    ASSERT_TRUE(pad.released(Button::B));
+}
+
+TEST(joypad_latch_waits_for_auto_read) {
+    LatchTestFixture f;
+
+    // HVBJOY bit 0 clear: latch reads immediately
+    f.fake.set_read_value(reg::HVBJOY::address, 0x80);
+    latch_frame(f, 0x0010, 0);
+    ASSERT_EQ(g_latch.history(0, 0), 0x0010);
+}
+
+// Record / replay tests
+
+TEST(joypad_record_run_length) {
+    u8 buf[29];
+    Recorder rec;
+    rec.begin(buf, sizeof(buf));
+
+    for (int i = 0; i < 300; i++) rec.push(0, 0, 0);
+    rec.push(0x0080, 0x0080, 0);
+    rec.push(0x0080, 0, 0);
+
+    // 255 + 45 idle frames, then 2 frames of A (pressed on the first)
+    ASSERT_EQ(rec.bytes(), 3 * RUN_BYTES + 1);
+    ASSERT_EQ(buf[0], 255);
+    ASSERT_EQ(buf[7], 45);
+    ASSERT_EQ(buf[14], 2);
+    ASSERT_EQ(buf[15], 0x80);
+    ASSERT_EQ(buf[17], 0x80);
+    ASSERT_EQ(buf[19], 0);
+    ASSERT_EQ(buf[21], 0);
+    ASSERT_FALSE(rec.overflow);
+
+    // Same held state but with edges starts a new run
+    rec.push(0x0080, 0x8000, 0x8000);
+    ASSERT_FALSE(rec.overflow);
+    ASSERT_EQ(buf[21], 1);
+    rec.push(0x0001, 0x0001, 0x0080);  // Needs 7 more bytes, buffer is full
+    ASSERT_TRUE(rec.overflow);
+    ASSERT_EQ(buf[rec.size], 0);
+}
+
+TEST(joypad_record_then_replay) {
+    JoypadTestFixture f;
+    u8 buf[64];
+    Recorder rec;
+    rec.begin(buf, sizeof(buf));
+
+    const u16 frames[] = {0, 0, 0x0080, 0x0080, 0x8080, 0, 0x0800, 0x0800};
+    Joypad live(0);
+    live.record(&rec);
+    for (u16 b : frames) {
+        f.set_joypad_state(0, b);
+        live.update();
+    }
+    live.record(nullptr);
+
+    // Replay ignores the hardware entirely
+    f.set_joypad_state(0, 0x0040);
+    Player player;
+    player.begin(buf);
+    Joypad ghost(0);
+    ghost.replay(&player);
+    for (u16 b : frames) {
+        ghost.update();
+        ASSERT_EQ(ghost.raw(), b);
+    }
+    ASSERT_TRUE(player.finished());
+
+    // Past the end: no buttons
+    ghost.update();
+    ASSERT_EQ(ghost.raw(), 0);
+    ASSERT_TRUE(ghost.released(Button::Up));
+}
+
+TEST(joypad_init_clears_garbage_latch) {
+    JoypadTestFixture f;
+
+    // Uninitialized BSS: latch looks enabled with stale snapshots
+    g_latch.enabled = true;
+    g_latch.count = 0x5A5A;
+    for (u8 i = 0; i < HISTORY_FRAMES; i++) g_latch.buttons[i][0] = 0xFFFF;
+
+    snes::init();
+    ASSERT_FALSE(g_latch.enabled);
+    ASSERT_EQ(g_latch.count, 0);
+
+    Joypad pad(0);
+    f.set_joypad_state(0, 0x0040);
+    pad.update();
+
+    ASSERT_TRUE(pad.held(Button::X));
+    ASSERT_FALSE(pad.held(Button::A));
+    ASSERT_EQ(pad.frames_since_update(), 0);
+}
+
+TEST(joypad_replay_keeps_lag_frame_taps) {
+    LatchTestFixture f;
+    u8 buf[64];
+    Recorder rec;
+    rec.begin(buf, sizeof(buf));
+
+    Joypad live(0);
+    live.record(&rec);
+    latch_frame(f, 0x0000, 0);
+    live.update();
+
+    // B tapped while the game lagged: never held at an update()
+    latch_frame(f, 0x8000, 0);
+    latch_frame(f, 0x0000, 0);
+    live.update();
+    ASSERT_TRUE(live.pressed(Button::B));
+
+    latch_frame(f, 0x0000, 0);
+    live.update();
+    live.record(nullptr);
+
+    Player player;
+    player.begin(buf);
+    Joypad ghost(0);
+    ghost.replay(&player);
+
+    ghost.update();
+    ASSERT_FALSE(ghost.pressed(Button::B));
+    ghost.update();
+    ASSERT_FALSE(ghost.held(Button::B));
+    ASSERT_TRUE(ghost.pressed(Button::B));
+    ASSERT_TRUE(ghost.released(Button::B));
+    ghost.update();
+    ASSERT_FALSE(ghost.pressed(Button::B));
+    ASSERT_FALSE(ghost.released(Button::B));
+    ASSERT_TRUE(player.finished());
+}
@@ -76,6 +76,125 @@ TEST(cos_180) {
     ASSERT_EQ(c.raw, -256);  // cos(180) = -1.0
 }
 
+TEST(sin_table_matches_quadrant_folding) {
+    // Full table agrees with the quarter table at every angle
+    for (int i = 0; i < 256; i++) {
+        u8 idx = static_cast<u8>(i);
+        i16 expected;
+        if (idx < 64) expected = detail::sin_quarter[idx];
+        else if (idx < 128) expected = detail::sin_quarter[128 - idx];
+        else if (idx < 192) expected = static_cast<i16>(-detail::sin_quarter[idx - 128]);
+        else expected = static_cast<i16>(-detail::sin_quarter[256 - idx]);
+        ASSERT_EQ(sin(Angle(idx)).raw, expected);
+        ASSERT_EQ(cos(Angle(idx)).raw, sin(Angle(static_cast<u8>(idx + 64))).raw);
+    }
+}
+
+TEST(atan2_axes_and_diagonals) {
+    ASSERT_EQ(atan2(0, 0).raw, 0);
+    ASSERT_EQ(atan2(0, 100).raw, 0);
+    ASSERT_EQ(atan2(100, 0).raw, 64);
+    ASSERT_EQ(atan2(0, -100).raw, 128);
+    ASSERT_EQ(atan2(-100, 0).raw, 192);
+    ASSERT_EQ(atan2(50, 50).raw, 32);
+    ASSERT_EQ(atan2(50, -50).raw, 96);
+    ASSERT_EQ(atan2(-50, -50).raw, 160);
+    ASSERT_EQ(atan2(-50, 50).raw, 224);
+    ASSERT_EQ(atan2(-32768, -32768).raw, 160);
+}
+
+TEST(atan2_inverts_sin_cos) {
+    // Round trip through the tables lands within one unit
+    for (int i = 0; i < 256; i++) {
+        Angle a(static_cast<u8>(i));
+        Angle back = atan2(static_cast<i16>(sin(a).raw * 64), static_cast<i16>(cos(a).raw * 64));
+        i8 err = static_cast<i8>(back.raw - a.raw);
+        ASSERT_TRUE(err >= -1 && err <= 1);
+    }
+}
+
+TEST(magnitude_within_bound) {
+    ASSERT_EQ(magnitude(0, 0), 0);
+    ASSERT_EQ(magnitude(300, 0), 300);
+    ASSERT_EQ(magnitude(0, -300), 300);
+    ASSERT_EQ(magnitude(-32768, -32768), 45056);
+
+    // 3-4-5 triangles scaled up: within 4%
+    for (i16 k = 20; k < 2000; k = static_cast<i16>(k + 37)) {
+        i32 m = magnitude(static_cast<i16>(3 * k), static_cast<i16>(-4 * k));
+        i32 exact = 5 * k;
+        ASSERT_TRUE(m * 100 >= exact * 96 && m * 100 <= exact * 104);
+    }
+}
+
+TEST(vec2_length_and_normalize) {
+    Vec2 v(3, 4);
+    ASSERT_TRUE(length(v).raw >= 5 * 256 * 96 / 100 && length(v).raw <= 5 * 256 * 104 / 100);
+
+    Vec2 n = normalize(Vec2(0, -7));
+    ASSERT_EQ(n.x.raw, 0);
+    ASSERT_EQ(n.y.raw, -256);
+
+    Vec2 d = normalize(Vec2(10, 10));
+    ASSERT_EQ(d.x.raw, 181);
+    ASSERT_EQ(d.y.raw, 181);
+}
+
+// Lookup table tests
+
+constexpr u16 lut_test_square(u16 i) { return static_cast<u16>(i * i); }
+
+TEST(lut_generated_at_compile_time) {
+    constexpr auto squares = make_lut<u16, 16>(lut_test_square);
+    static_assert(squares[15] == 225, "evaluated by the compiler");
+    static_assert(decltype(squares)::size == 16, "size");
+
+    constexpr auto halves = make_lut<i8, 4>([](u16 i) { return -static_cast<int>(i) / 2; });
+    ASSERT_EQ(halves[3], -1);
+    ASSERT_EQ(squares[7], 49);
+}
+
+TEST(lut_reciprocals) {
+    constexpr auto recip = make_lut<u16, 64>(lut::reciprocal);
+    ASSERT_EQ(recip[0], 0xFFFF);
+    ASSERT_EQ(recip[1], 0xFFFF);
+    for (u16 n = 2; n < 64; n++) {
+        // n * (65536 / n) lands within n of 65536
+        u32 back = static_cast<u32>(recip[n]) * n;
+        ASSERT_TRUE(back <= 65536u && back > 65536u - n);
+    }
+}
+
+TEST(lut_easing_curves) {
+    constexpr auto in = make_lut<u8, 32>(lut::ease_in<32>);
+    constexpr auto out = make_lut<u8, 32>(lut::ease_out<32>);
+    constexpr auto smooth = make_lut<u8, 32>(lut::smoothstep<32>);
+
+    ASSERT_EQ(in[0], 0);
+    ASSERT_EQ(in[31], 255);
+    ASSERT_EQ(out[0], 0);
+    ASSERT_EQ(out[31], 255);
+    ASSERT_EQ(smooth[0], 0);
+    ASSERT_EQ(smooth[31], 255);
+    for (u16 i = 1; i < 32; i++) {
+        ASSERT_TRUE(in[i] >= in[i - 1]);
+        ASSERT_TRUE(out[i] >= out[i - 1]);
+        ASSERT_TRUE(smooth[i] >= smooth[i - 1]);
+        ASSERT_TRUE(in[i] <= out[i]);  // ease-in lags, ease-out leads
+    }
+    ASSERT_TRUE(smooth[8] < 128 && smooth[23] > 128);
+}
+
+TEST(lut_palette_fade) {
+    constexpr auto fade = make_lut<u8, 512>(lut::fade);
+    for (u16 level = 0; level < 16; level++) {
+        for (u16 c = 0; c < 32; c++) {
+            ASSERT_EQ(fade[static_cast<u16>((level << 5) | c)], c * level / 15);
+        }
+    }
+    ASSERT_EQ(fade[(15 << 5) | 31], 31);
+}
+
 // Min/Max/Clamp tests
 TEST(min_int) {
     ASSERT_EQ(min(3, 5), 3);
@@ -169,3 +288,54 @@ TEST(random_zero_seed_handled) {
     ASSERT_NE(a, 0u);  // Shouldn't be stuck at 0
     ASSERT_NE(a, b);
 }
+
+// Random engine tests
+
+template<typename Engine>
+static u32 rng_period(u16 seed) {
+    Engine e;
+    e.seed(seed);
+    u16 first = e.next();
+    u32 n = 1;
+    while (e.next() != first && n < 70000) n++;
+    return n;
+}
+
+TEST(random_engines_full_period) {
+    ASSERT_EQ(rng_period<rng::Lfsr>(1), 65535u);
+    ASSERT_EQ(rng_period<rng::Xorshift>(1), 65535u);
+    ASSERT_EQ(rng_period<rng::ByteLfsr>(1), 65535u);
+}
+
+TEST(random_byte_lfsr_matches_eight_galois_steps) {
+    rng::ByteLfsr fast;
+    fast.seed(0x1234);
+    u16 slow = 0x1234;
+    for (int i = 0; i < 100; i++) {
+        for (int b = 0; b < 8; b++) {
+            slow = static_cast<u16>((slow & 1) ? ((slow >> 1) ^ rng::detail::GALOIS_TAPS) : (slow >> 1));
+        }
+        ASSERT_EQ(fast.next(), slow);
+    }
+}
+
+TEST(random_engines_zero_seed) {
+    XorshiftRandom x(0);
+    ByteRandom b(0);
+    ASSERT_NE(x.next(), 0u);
+    ASSERT_NE(b.next(), 0u);
+}
+
+TEST(random_fill_bytes) {
+    XorshiftRandom a(77);
+    XorshiftRandom b(77);
+    u8 buf[7] = {0};
+
+    a.fill(buf, 7);
+    u16 r0 = b.next();
+    ASSERT_EQ(buf[0], r0 & 0xFF);
+    ASSERT_EQ(buf[1], r0 >> 8);
+    b.next();
+    b.next();
+    ASSERT_EQ(buf[6], b.next() >> 8);
+}
@@ -0,0 +1,157 @@
+// Unit tests for the hardware multiply/divide API
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/math.hpp>
+
+using namespace snes;
+
+// Fake HAL that models the CPU multiply/divide unit
+struct FakeMulDiv : snes::testing::FakeRegisterAccess {
+    u8 mpya = 0;
+    u16 dividend = 0;
+    u16 quotient = 0;
+    u16 product = 0;  // RDMPY: product or remainder
+    int operations = 0;
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr == reg::WRMPYA::address) {
+            mpya = val;
+        } else if (addr == reg::WRMPYB::address) {
+            product = static_cast<u16>(mpya * val);
+            operations++;
+        } else if (addr == reg::WRDIVL::address) {
+            dividend = static_cast<u16>((dividend & 0xFF00) | val);
+        } else if (addr == reg::WRDIVH::address) {
+            dividend = static_cast<u16>((dividend & 0x00FF) | (val << 8));
+        } else if (addr == reg::WRDIVB::address) {
+            quotient = val ? static_cast<u16>(dividend / val) : 0xFFFF;
+            product = val ? static_cast<u16>(dividend % val) : dividend;
+            operations++;
+        }
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr == reg::RDDIVL::address) return static_cast<u8>(quotient & 0xFF);
+        if (addr == reg::RDDIVH::address) return static_cast<u8>(quotient >> 8);
+        if (addr == reg::RDMPYL::address) return static_cast<u8>(product & 0xFF);
+        if (addr == reg::RDMPYH::address) return static_cast<u8>(product >> 8);
+        return FakeRegisterAccess::read8(addr);
+    }
+};
+
+TEST(math_hw_mul_and_div) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    ASSERT_EQ(math::hw::mul8(200, 250), 50000);
+    ASSERT_EQ(math::hw::mul16(300, 700), 210000u);
+    ASSERT_EQ(math::hw::mul16(65535, 65535), 4294836225u);
+
+    math::hw::DivResult r = math::hw::div(1000, 7);
+    ASSERT_EQ(r.quotient, 142);
+    ASSERT_EQ(r.remainder, 6);
+    ASSERT_EQ(math::hw::div(5, 0).quotient, 0xFFFF);
+}
+
+TEST(math_hw_pipelined_divide) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    math::hw::div_start(12345, 100);
+    ASSERT_TRUE(fake.wrote16(reg::WRDIV::address, 12345));
+    ASSERT_EQ(fake.last_write(reg::WRDIVB::address), 100);
+
+    ASSERT_EQ(math::hw::div_quotient(), 123);
+    ASSERT_EQ(math::hw::div_remainder(), 45);
+}
+
+TEST(math_hw_fixed8_matches_software) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    const i16 values[] = {0, 1, -1, 128, -128, 255, -255, 256, -384, 1000, -7000, 32767, -32768};
+    for (i16 a : values) {
+        for (i16 b : values) {
+            ASSERT_EQ(math::hw::mul(Fixed8(a), Fixed8(b)).raw, (Fixed8(a) * Fixed8(b)).raw);
+            if (b != 0) {
+                ASSERT_EQ(math::hw::div(Fixed8(a), Fixed8(b)).raw, (Fixed8(a) / Fixed8(b)).raw);
+            }
+        }
+    }
+}
+
+TEST(math_hw_fixed_i8_matches_software) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    using Fixed4 = Fixed<4, 4, i8>;
+    for (int a = -128; a < 128; a++) {
+        for (int b = -128; b < 128; b++) {
+            Fixed4 x(static_cast<i8>(a));
+            Fixed4 y(static_cast<i8>(b));
+            ASSERT_EQ(math::hw::mul(x, y).raw, (x * y).raw);
+        }
+    }
+}
+
+TEST(math_hw_div_large_divisor_uses_software) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    ASSERT_EQ(math::hw::div(Fixed8::from_int(10), Fixed8::from_int(4)).raw, 640);
+    ASSERT_EQ(fake.operations, 0);
+}
+
+TEST(math_hw_lerp_matches_software) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    const i16 ends[] = {0, 100, -100, 32767, -32768};
+    const u8 ts[] = {0, 1, 64, 128, 255};
+    for (i16 a : ends) {
+        for (i16 b : ends) {
+            for (u8 t : ts) {
+                ASSERT_EQ(math::lerp_hw(a, b, t), math::lerp(a, b, t));
+            }
+        }
+    }
+    ASSERT_EQ(math::lerp_hw(Fixed8(256), Fixed8(512), 128).raw, 384);
+}
+
+TEST(math_hw_random_range) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    Random hw_rng(1234);
+    Random sw_rng(1234);
+    for (int i = 0; i < 50; i++) {
+        u8 v = hw_rng.range_hw(10);
+        ASSERT_EQ(v, sw_rng.range(10));
+        ASSERT_TRUE(v < 10);
+    }
+    ASSERT_EQ(hw_rng.range_hw(0), 0);
+}
+
+TEST(math_hw_random_range_mul) {
+    FakeMulDiv fake;
+    hal::set_hal(fake);
+
+    ByteRandom rng(99);
+    ByteRandom ref(99);
+    u16 counts[6] = {0};
+    for (int i = 0; i < 600; i++) {
+        u8 v = rng.range_mul(6);
+        ASSERT_EQ(v, ((ref.next() >> 8) * 6) >> 8);
+        counts[v]++;
+    }
+    for (int i = 0; i < 6; i++) ASSERT_TRUE(counts[i] > 60);
+    ASSERT_EQ(fake.operations, 600);
+
+    u8 buf[32];
+    rng.fill_range(buf, 32, 10);
+    for (int i = 0; i < 32; i++) ASSERT_TRUE(buf[i] < 10);
+}
@@ -0,0 +1,247 @@
+// Unit tests for the Mode 7 camera
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/mode7.hpp>
+
+using namespace snes;
+using namespace snes::mode7;
+
+// Fake that also models the PPU multiplier: M7A (write twice) x last M7B byte
+struct FakeMultiplier : snes::testing::FakeRegisterAccess {
+    u8 m7_latch = 0;
+    i16 m7a = 0;
+    i32 product = 0;
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr == reg::M7A::address) {
+            m7a = static_cast<i16>(m7_latch | (val << 8));
+            m7_latch = val;
+        } else if (addr == reg::M7B::address) {
+            product = static_cast<i32>(m7a) * static_cast<i8>(val);
+            m7_latch = val;
+        }
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr == reg::MPYL::address) return static_cast<u8>(product & 0xFF);
+        if (addr == reg::MPYM::address) return static_cast<u8>((product >> 8) & 0xFF);
+        if (addr == reg::MPYH::address) return static_cast<u8>((product >> 16) & 0xFF);
+        return FakeRegisterAccess::read8(addr);
+    }
+};
+
+TEST(mode7_ppu_mul_signed) {
+    FakeMultiplier fake;
+    hal::set_hal(fake);
+
+    ASSERT_EQ(ppu_mul(1000, 100), 100000);
+    ASSERT_EQ(ppu_mul(-1000, 100), -100000);
+    ASSERT_EQ(ppu_mul(-32768, -128), 4194304);
+}
+
+TEST(mode7_ppu_mul_fixed_matches_software) {
+    FakeMultiplier fake;
+    hal::set_hal(fake);
+
+    const i16 as[] = {256, -256, 384, 1000, -7000};
+    const i16 bs[] = {0, 181, -181, 256, -256, 255, 1};
+    for (i16 a : as) {
+        for (i16 b : bs) {
+            ASSERT_EQ(ppu_mul_fixed(a, b), (Fixed8(a) * Fixed8(b)).raw);
+        }
+    }
+}
+
+TEST(mode7_matrix_identity_and_rotation) {
+    Matrix m = matrix(Angle(0), Fixed8::from_int(1), Fixed8::from_int(1));
+    ASSERT_EQ(m.a, 256);
+    ASSERT_EQ(m.b, 0);
+    ASSERT_EQ(m.c, 0);
+    ASSERT_EQ(m.d, 256);
+
+    m = matrix(Angle(64), Fixed8::from_int(2), Fixed8::from_int(1));
+    ASSERT_EQ(m.a, 0);
+    ASSERT_EQ(m.b, 512);
+    ASSERT_EQ(m.c, -256);
+    ASSERT_EQ(m.d, 0);
+}
+
+TEST(mode7_matrix_ppu_matches_software) {
+    FakeMultiplier fake;
+    hal::set_hal(fake);
+
+    for (int a = 0; a < 256; a += 13) {
+        Matrix hw = matrix_ppu(Angle(static_cast<u8>(a)), Fixed8(300), Fixed8(200));
+        Matrix sw = matrix(Angle(static_cast<u8>(a)), Fixed8(300), Fixed8(200));
+        ASSERT_EQ(hw.a, sw.a);
+        ASSERT_EQ(hw.b, sw.b);
+        ASSERT_EQ(hw.c, sw.c);
+        ASSERT_EQ(hw.d, sw.d);
+    }
+}
+
+TEST(mode7_camera_commit_once) {
+    FakeMultiplier fake;
+    hal::set_hal(fake);
+
+    Camera cam;
+    cam.reset();
+    cam.set_angle(Angle(32));
+    cam.look_at(512, 512);
+
+    ASSERT_TRUE(cam.commit());
+    ASSERT_FALSE(cam.commit());
+
+    Matrix expected = cam.matrix();
+    u8 d_bytes[8];
+    int n = fake.get_writes(reg::M7D::address, d_bytes, 8);
+    ASSERT_EQ(n, 2);
+    ASSERT_EQ(static_cast<i16>(d_bytes[0] | (d_bytes[1] << 8)), expected.d);
+    ASSERT_EQ(fake.last_write(reg::M7X::address), 0x02);
+    ASSERT_EQ(fake.last_write(reg::BG1HOFS::address), 0x01);  // 384 = 0x180
+}
+
+// Fake that models the CPU's unsigned 8x8 multiplier, for Floor::update()
+struct FakeCpuMultiplier : snes::testing::FakeRegisterAccess {
+    u8 wrmpya = 0;
+    u16 product = 0;
+    int multiplies = 0;
+
+    void write8(u32 addr, u8 val) override {
+        FakeRegisterAccess::write8(addr, val);
+        if (addr == reg::WRMPYA::address) {
+            wrmpya = val;
+        } else if (addr == reg::WRMPYB::address) {
+            product = static_cast<u16>(wrmpya * val);
+            multiplies++;
+        }
+    }
+
+    u8 read8(u32 addr) override {
+        if (addr == reg::RDMPYL::address) return static_cast<u8>(product & 0xFF);
+        if (addr == reg::RDMPYH::address) return static_cast<u8>(product >> 8);
+        return FakeRegisterAccess::read8(addr);
+    }
+};
+
+static_assert(mode7::detail::reciprocals.v[2] == 32768, "reciprocal of 2");
+static_assert(mode7::detail::reciprocals.v[224] == 292, "reciprocal of 224");
+
+TEST(mode7_floor_tables_cover_screen) {
+    FakeCpuMultiplier fake;
+    hal::set_hal(fake);
+
+    static Floor floor;
+    floor.reset();
+    floor.set_camera(40, 63);
+    ASSERT_TRUE(floor.update());
+    ASSERT_FALSE(floor.update());
+
+    const FloorTable& t = floor.ad.back();
+    ASSERT_EQ(t.lines(), FLOOR_LINES);
+    ASSERT_EQ(floor.b.back().lines(), FLOOR_LINES);
+
+    // Scale shrinks toward the bottom of the screen
+    ASSERT_EQ(floor.scale[64], static_cast<i16>((40UL * 0xFFFF) >> 8));
+    ASSERT_GT(floor.scale[100], floor.scale[200]);
+
+    // Angle 0: A = scale, B = C = 0
+    ASSERT_EQ(t.bytes[0], 64);  // Hold through the horizon line
+    ASSERT_EQ(t.bytes[3], 0x80 | 127);
+    ASSERT_EQ(static_cast<u16>(t.bytes[4] | (t.bytes[5] << 8)), static_cast<u16>(floor.scale[64]));
+}
+
+TEST(mode7_floor_angle_only_keeps_scales) {
+    FakeCpuMultiplier fake;
+    hal::set_hal(fake);
+
+    static Floor floor;
+    floor.reset();
+    floor.set_camera(40, 63);
+    floor.update();
+
+    floor.scale[100] = 1000;  // Would be overwritten by a scale pass
+    floor.set_angle(Angle(64));
+    ASSERT_TRUE(floor.update());
+    ASSERT_EQ(floor.scale[100], 1000);
+
+    // Angle 64: B holds the scale, C its negation, A is zero
+    const FloorTable& tb = floor.b.back();
+    const FloorTable& tc = floor.c.back();
+    u16 line100 = static_cast<u16>(4 + (100 - 64) * 2);
+    ASSERT_EQ(static_cast<i16>(tb.bytes[line100] | (tb.bytes[line100 + 1] << 8)), 1000);
+    ASSERT_EQ(static_cast<i16>(tc.bytes[line100] | (tc.bytes[line100 + 1] << 8)), -1000);
+}
+
+TEST(mode7_floor_matches_software_products) {
+    FakeCpuMultiplier fake;
+    hal::set_hal(fake);
+
+    static Floor floor;
+    floor.reset();
+    floor.set_camera(40, 63);
+    floor.update();
+
+    for (u16 a = 3; a < 256; a += 7) {
+        floor.set_angle(Angle(static_cast<u8>(a)));
+        fake.multiplies = 0;
+        ASSERT_TRUE(floor.update());
+
+        // Angle change cost: at most 4 hardware multiplies per floor line
+        ASSERT_LE(fake.multiplies, 4 * (FLOOR_LINES - 64));
+
+        i32 cs = math::cos(Angle(static_cast<u8>(a))).raw;
+        i32 sn = math::sin(Angle(static_cast<u8>(a))).raw;
+        const FloorTable& ta = floor.ad.back();
+        const FloorTable& tb = floor.b.back();
+        const FloorTable& tc = floor.c.back();
+        for (u8 y = 64; y < FLOOR_LINES; y++) {
+            // Second run starts after another header byte
+            u16 at = static_cast<u16>(4 + (y - 64) * 2 + (y >= 64 + 127 ? 1 : 0));
+            i16 bv = static_cast<i16>((sn * floor.scale[y]) >> 8);
+            ASSERT_EQ(static_cast<i16>(ta.bytes[at] | (ta.bytes[at + 1] << 8)),
+                      static_cast<i16>((cs * floor.scale[y]) >> 8));
+            ASSERT_EQ(static_cast<i16>(tb.bytes[at] | (tb.bytes[at + 1] << 8)), bv);
+            ASSERT_EQ(static_cast<i16>(tc.bytes[at] | (tc.bytes[at + 1] << 8)),
+                      static_cast<i16>(-bv));
+        }
+        ASSERT_EQ(tb.lines(), FLOOR_LINES);
+    }
+
+    // Right angles need no multiplies at all
+    floor.set_angle(Angle(128));
+    fake.multiplies = 0;
+    floor.update();
+    ASSERT_EQ(fake.multiplies, 0);
+}
+
+TEST(mode7_floor_claims_and_commits) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+    dma::g_channels.reset();
+
+    static Floor floor;
+    floor.reset();
+    ASSERT_FALSE(floor.commit());
+    ASSERT_TRUE(floor.claim_channels());
+    ASSERT_EQ(floor.channel_mask(), 0xF0);
+    ASSERT_EQ(fake.last_write(reg::DMA<7>::DEST::address), 0x1B);
+    ASSERT_EQ(fake.last_write(reg::DMA<4>::DEST::address), 0x1E);
+
+    floor.update();
+    fake.clear();
+    ASSERT_TRUE(floor.commit());
+    ASSERT_EQ(fake.count_writes16(reg::DMA<7>::SRCL::address), 1);
+    ASSERT_EQ(fake.count_writes16(reg::DMA<4>::SRCL::address), 1);
+    ASSERT_FALSE(floor.commit());
+
+    // Four channels left, but one is kept for GPDMA: a second floor cannot claim
+    static Floor other;
+    other.reset();
+    ASSERT_FALSE(other.claim_channels());
+    ASSERT_EQ(dma::g_channels.hdma_mask, 0xF0);
+}
@@ -0,0 +1,64 @@
+// Unit tests for 16-bit register pair writes
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/dma.hpp>
+#include <snes/ppu.hpp>
+
+using namespace snes;
+
+TEST(reg16_single_store) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    reg::VMADD::write(0x1234);
+
+    ASSERT_EQ(fake.write_count, 2);
+    ASSERT_EQ(fake.count_writes16(reg::VMADDL::address), 1);
+    ASSERT_TRUE(fake.wrote16(reg::VMADDL::address, 0x1234));
+    ASSERT_EQ(fake.last_write(reg::VMADDL::address), 0x34);
+    ASSERT_EQ(fake.last_write(reg::VMADDH::address), 0x12);
+}
+
+TEST(reg16_byte_writes_not_paired) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    reg::VMADDL::write(0x34);
+    reg::VMADDH::write(0x12);
+
+    ASSERT_EQ(fake.count_writes16(reg::VMADDL::address), 0);
+    ASSERT_FALSE(fake.wrote16(reg::VMADDL::address, 0x1234));
+}
+
+TEST(reg16_dma_source_and_size) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    dma::set_source<3>(0x7E1234);
+    dma::set_size<3>(0x0220);
+    dma::set_source(5, 0x7FABCD);
+    dma::set_size(5, 0x1000);
+
+    ASSERT_TRUE(fake.wrote16(reg::DMA<3>::SRCL::address, 0x1234));
+    ASSERT_EQ(fake.last_write(reg::DMA<3>::SRCH::address), 0x7E);
+    ASSERT_TRUE(fake.wrote16(reg::DMA<3>::SIZEL::address, 0x0220));
+    ASSERT_TRUE(fake.wrote16(reg::DMA<5>::SRCL::address, 0xABCD));
+    ASSERT_EQ(fake.last_write(reg::DMA<5>::SRCH::address), 0x7F);
+    ASSERT_TRUE(fake.wrote16(reg::DMA<5>::SIZEL::address, 0x1000));
+    ASSERT_EQ(fake.write_count, 10);
+}
+
+TEST(reg16_vram_transfer_setup) {
+    snes::testing::FakeRegisterAccess fake;
+    hal::set_hal(fake);
+
+    static const u8 data[4] = {};
+    dma::transfer_to_vram(data, 0x6000, 4);
+
+    ASSERT_TRUE(fake.wrote16(reg::VMADDL::address, 0x6000));
+    ASSERT_TRUE(fake.wrote16(reg::DMA<0>::SIZEL::address, 4));
+    ASSERT_EQ(fake.count_writes(reg::MDMAEN::address), 1);
+}
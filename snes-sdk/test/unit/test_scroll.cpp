@@ -0,0 +1,188 @@
+// Unit tests for the streaming tilemap scroller
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/scroll.hpp>
+
+using namespace snes;
+
+// Shadow entry for hardware tile (c, r)
+static u16 shadow_at(const scroll::Scroller& s, u8 c, u8 r) {
+    return s.shadow[(c >> 5) * 0x400 + r * 32 + (c & 31)];
+}
+
+static u16 g_scroll_world[64 * 128];
+
+// 128x64 world where each entry encodes its own position
+struct ScrollTestFixture {
+    snes::testing::FakeRegisterAccess fake;
+    scroll::Scroller s;
+
+    ScrollTestFixture() {
+        for (u16 r = 0; r < 64; r++) {
+            for (u16 c = 0; c < 128; c++) {
+                g_scroll_world[r * 128 + c] = static_cast<u16>((r << 8) | c);
+            }
+        }
+        fake.clear();
+        hal::set_hal(fake);
+        dma::g_queue.reset();
+        s.init(1, 0x2000, g_scroll_world, 128, 64);
+        s.load(0, 0);
+        fake.clear();
+    }
+};
+
+TEST(scroll_load_fills_window) {
+    ScrollTestFixture f;
+    snes::testing::FakeRegisterAccess& fake = f.fake;
+    scroll::Scroller& s = f.s;
+    s.init(1, 0x2000, g_scroll_world, 128, 64);
+
+    s.load(0, 0);
+
+    // Whole map in one DMA from the shadow
+    ASSERT_EQ(fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_TRUE(fake.wrote(reg::VMAIN::address, 0x80));
+    ASSERT_TRUE(fake.wrote16(reg::VMADDL::address, 0x2000));
+    ASSERT_EQ(fake.last_write(reg::DMA<0>::SIZEH::address), 0x10);
+    ASSERT_EQ(shadow_at(s, 5, 7), (7 << 8) | 5);
+    ASSERT_EQ(shadow_at(s, 48, 0), 0);  // World column -16
+    ASSERT_EQ(shadow_at(s, 47, 29), (29 << 8) | 47);
+    ASSERT_EQ(shadow_at(s, 47, 30), 0);  // World row -2
+    ASSERT_FALSE(s.full_reload);
+    ASSERT_EQ(s.commit(), 0);
+}
+
+TEST(scroll_sub_tile_move_sends_nothing) {
+    ScrollTestFixture f;
+
+    f.s.scroll_to(7, 5);
+    ASSERT_EQ(f.s.commit(), 0);
+    ASSERT_FALSE(f.fake.wrote_to(reg::MDMAEN::address));
+    ASSERT_EQ(f.fake.last_write(reg::BG1HOFS::address), 0);  // High byte last
+    ASSERT_EQ(f.fake.count_writes(reg::BG1HOFS::address), 2);
+}
+
+TEST(scroll_right_streams_one_column) {
+    ScrollTestFixture f;
+
+    f.s.scroll_to(8, 0);
+    ASSERT_EQ(f.s.col_count, 1);
+
+    // New column is world column 1 - 16 + 63 = 48: hardware column 48,
+    // second screen, column 16
+    ASSERT_EQ(f.s.col_hw[0], 48);
+    ASSERT_EQ(f.s.col_buf[0][5], (5 << 8) | 48);
+    ASSERT_EQ(f.s.col_buf[0][30], 0);  // Row -2 is outside the world
+
+    ASSERT_EQ(f.s.commit(), 64);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_EQ(f.fake.last_write(reg::VMAIN::address), 0x81);
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADDL::address, 0x2000 + 0x400 + 16));
+}
+
+TEST(scroll_down_streams_one_row) {
+    ScrollTestFixture f;
+
+    f.s.scroll_to(0, 8);
+    ASSERT_EQ(f.s.row_count, 1);
+
+    // New row is 1 - 2 + 31 = 30, over columns -16..47
+    ASSERT_EQ(f.s.row_hw[0], 30);
+    ASSERT_EQ(shadow_at(f.s, 47, 30), (30 << 8) | 47);
+    ASSERT_EQ(shadow_at(f.s, 48, 30), 0);  // Column -16
+
+    ASSERT_EQ(f.s.commit(), 128);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADDL::address, 0x2000 + 30 * 32));
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADDL::address, 0x2000 + 0x400 + 30 * 32));
+}
+
+TEST(scroll_left_streams_trailing_column) {
+    ScrollTestFixture f;
+    f.s.load(64, 0);
+    f.fake.clear();
+
+    f.s.scroll_to(56, 0);
+    ASSERT_EQ(f.s.col_count, 1);
+    ASSERT_EQ(f.s.col_hw[0], (7 - 16) & 63);
+    ASSERT_EQ(f.s.col_buf[0][3], 0);  // World column -9
+}
+
+TEST(scroll_fast_move_reloads) {
+    ScrollTestFixture f;
+    dma::g_queue.reset(2048);
+
+    // The window is regathered in scroll_to() and queued, not sent in VBlank
+    f.s.scroll_to(40, 0);
+    ASSERT_FALSE(f.s.full_reload);
+    ASSERT_EQ(dma::g_queue.pending_bytes(), 64 * 64);
+    ASSERT_EQ(shadow_at(f.s, 5, 3), (3 << 8) | 5);
+    ASSERT_EQ(shadow_at(f.s, 53, 3), 0);  // World column -11
+    ASSERT_EQ(f.s.commit(), 0);
+    ASSERT_FALSE(f.fake.wrote_to(reg::MDMAEN::address));
+
+    // The budget spreads it over two frames
+    ASSERT_EQ(dma::flush_queue(), 2048);
+    ASSERT_EQ(dma::flush_queue(), 2048);
+    ASSERT_TRUE(dma::g_queue.empty());
+
+    f.s.scroll_to(48, 0);
+    ASSERT_EQ(f.s.commit(), 64);
+}
+
+TEST(scroll_reload_retries_when_queue_full) {
+    ScrollTestFixture f;
+    static u8 filler[2];
+    while (dma::queue_vram(filler, 0, 2)) {}
+
+    f.s.scroll_to(40, 0);
+    ASSERT_TRUE(f.s.full_reload);
+
+    dma::g_queue.reset();
+    f.s.scroll_to(48, 0);
+    ASSERT_FALSE(f.s.full_reload);
+    ASSERT_EQ(dma::g_queue.pending_bytes(), 64 * 64);
+    ASSERT_EQ(f.s.tile_x, 6);
+}
+
+TEST(scroll_edge_during_reload_patches_shadow) {
+    ScrollTestFixture f;
+    dma::g_queue.reset(1024);
+
+    f.s.scroll_to(40, 0);
+    dma::flush_queue();  // First quarter sent
+
+    // Moving down one tile replaces hardware row 30 (world row -2 -> 30)
+    f.s.scroll_to(40, 8);
+    ASSERT_EQ(f.s.commit(), 128);
+    ASSERT_EQ(shadow_at(f.s, 10, 30), (30 << 8) | 10);
+
+    // The queued remainder sends from the same shadow
+    const dma::Transfer& rest = dma::g_queue.front();
+    ASSERT_TRUE(rest.src == reinterpret_cast<const u8*>(f.s.shadow) + 1024);
+}
+
+TEST(scroll_edges_match_fresh_load) {
+    ScrollTestFixture f;
+    scroll::Scroller fresh;
+    fresh.init(1, 0x2000, g_scroll_world, 128, 64);
+
+    // Walk diagonally past the right and bottom edges of the world
+    u16 x = 0, y = 0;
+    for (u16 i = 0; i < 160; i++) {
+        x = static_cast<u16>(x + 8);
+        if (i & 1) y = static_cast<u16>(y + 8);
+        f.s.scroll_to(x, y);
+        f.s.commit();
+    }
+    ASSERT_FALSE(f.s.full_reload);
+
+    fresh.load(x, y);
+    for (u16 i = 0; i < scroll::MAP_COLS * scroll::MAP_ROWS; i++) {
+        ASSERT_EQ(f.s.shadow[i], fresh.shadow[i]);
+    }
+}
@@ -27,6 +27,7 @@ struct SpriteTestFixture {
         for (int i = 0; i < 32; i++) {
             oam_high[i] = 0;
         }
+        oam_dirty.clear();
     }
 };
 
@@ -216,3 +217,145 @@ TEST(sprites_clear_all) {
         ASSERT_EQ(oam_low[i].y, 240);
     }
 }
+
+TEST(sprites_upload_nothing_dirty) {
+    SpriteTestFixture f;
+
+    ASSERT_EQ(sprites_upload(), 0);
+    ASSERT_FALSE(f.fake.wrote_to(reg::MDMAEN::address));
+}
+
+TEST(sprites_upload_dirty_low_span) {
+    SpriteTestFixture f;
+
+    Sprite(5).set_tile(1);
+    Sprite(9).set_priority(2);
+
+    // Sprites 5-9: 20 bytes starting at OAM word 10, high table untouched
+    ASSERT_EQ(sprites_upload(), 20);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_TRUE(f.fake.wrote16(reg::OAMADDL::address, 10));
+    ASSERT_TRUE(f.fake.wrote16(reg::DMA<0>::SIZEL::address, 20));
+    ASSERT_TRUE(oam_dirty.empty());
+}
+
+TEST(sprites_upload_dirty_high_bytes) {
+    SpriteTestFixture f;
+
+    // Sprite 20 X high bit lives in high byte 5, sent as the pair 4-5
+    Sprite(20).set_pos(300, 50);
+
+    ASSERT_EQ(sprites_upload(), 4 + 2);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_TRUE(f.fake.wrote16(reg::OAMADDL::address, 40));
+    ASSERT_TRUE(f.fake.wrote16(reg::OAMADDL::address, 256 + 2));
+}
+
+TEST(sprites_upload_x_high_unchanged_skips_high_table) {
+    SpriteTestFixture f;
+
+    Sprite(3).set_pos(10, 10);
+
+    ASSERT_EQ(sprites_upload(), 4);
+}
+
+TEST(sprites_upload_force_full) {
+    SpriteTestFixture f;
+
+    ASSERT_EQ(sprites_upload(true), 544);
+    ASSERT_TRUE(f.fake.wrote16(reg::OAMADDL::address, 0));
+    ASSERT_TRUE(f.fake.wrote16(reg::DMA<0>::SIZEL::address, 0x0220));
+
+    sprites_clear();
+    ASSERT_EQ(sprites_upload(), 544);
+}
+
+TEST(sprite_pool_packs_from_zero) {
+    SpriteTestFixture f;
+    SpritePool pool;
+    pool.reset();
+
+    pool.begin_frame();
+    ASSERT_EQ(pool.alloc(), 0);
+    ASSERT_EQ(pool.alloc(), 1);
+    ASSERT_EQ(pool.alloc(), 2);
+    pool.end_frame();
+
+    pool.begin_frame();
+    ASSERT_EQ(pool.alloc(), 0);
+}
+
+TEST(sprite_pool_hides_only_tail) {
+    SpriteTestFixture f;
+    SpritePool pool;
+    pool.reset();
+
+    pool.begin_frame();
+    for (int i = 0; i < 10; i++) {
+        Sprite(pool.alloc()).set_pos(10, 20);
+    }
+    pool.end_frame();
+    sprites_upload();
+
+    pool.begin_frame();
+    for (int i = 0; i < 4; i++) {
+        Sprite(pool.alloc()).set_pos(10, 30);
+    }
+    pool.end_frame();
+
+    ASSERT_EQ(oam_low[3].y, 30);
+    ASSERT_EQ(oam_low[4].y, 240);
+    ASSERT_EQ(oam_low[9].y, 240);
+    ASSERT_EQ(oam_dirty.low_first, 0);
+    ASSERT_EQ(oam_dirty.low_last, 9);
+}
+
+TEST(sprite_pool_runs_out) {
+    SpriteTestFixture f;
+    SpritePool pool;
+    pool.reset();
+
+    pool.begin_frame();
+    for (int i = 0; i < 128; i++) {
+        ASSERT_NE(pool.alloc(), NO_SPRITE);
+    }
+    ASSERT_EQ(pool.alloc(), NO_SPRITE);
+}
+
+TEST(sprite_pool_rotates_when_crowded) {
+    SpriteTestFixture f;
+    SpritePool pool;
+    pool.reset();
+
+    // 32 or fewer: no rotation
+    pool.begin_frame();
+    for (int i = 0; i < 32; i++) pool.alloc();
+    pool.end_frame();
+    ASSERT_EQ(pool.first, 0);
+
+    // 40 live: 32, then (32 + 32) % 40 = 24
+    pool.begin_frame();
+    for (int i = 0; i < 40; i++) pool.alloc();
+    pool.end_frame();
+    ASSERT_EQ(pool.first, 32);
+
+    pool.begin_frame();
+    for (int i = 0; i < 40; i++) pool.alloc();
+    pool.end_frame();
+    ASSERT_EQ(pool.first, 24);
+
+    pool.upload();
+    // Priority rotation bit plus sprite 24 as a word address
+    ASSERT_TRUE(f.fake.wrote16(reg::OAMADDL::address, 0x8000 | 48));
+}
+
+TEST(sprite_pool_rotation_disabled) {
+    SpriteTestFixture f;
+    SpritePool pool;
+    pool.reset(false);
+
+    pool.begin_frame();
+    for (int i = 0; i < 100; i++) pool.alloc();
+    pool.end_frame();
+    ASSERT_EQ(pool.first, 0);
+}
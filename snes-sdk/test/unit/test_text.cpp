@@ -0,0 +1,241 @@
+// Unit tests for the text shadow tilemap
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include "fake_hal.hpp"
+#include <snes/text.hpp>
+#include <snes/dma.hpp>
+#include <snes/vblank.hpp>
+
+using namespace snes;
+
+// Helper to set up fake HAL and a cleared, flushed screen
+struct TextTestFixture {
+    snes::testing::FakeRegisterAccess fake;
+
+    TextTestFixture() {
+        hal::set_hal(fake);
+        vblank::clear_hooks();
+        dma::g_channels.reset();
+        text::init(0x1000, 0x20, 1);
+        text::clear();
+        text::flush();
+        fake.clear();
+    }
+};
+
+TEST(text_putchar_writes_shadow_only) {
+    TextTestFixture f;
+
+    text::putchar('A');
+
+    // Tile 0x20 + ('A' - 32), palette 1 in bits 10-12
+    ASSERT_EQ(text::g_shadow[0], 0x20 + 33 + (1 << 10));
+    ASSERT_EQ(text::g_dirty_rows, 1u);
+    ASSERT_EQ(f.fake.write_count, 0);
+}
+
+TEST(text_putchar_masks_tile_number) {
+    TextTestFixture f;
+    text::init(0x1000, 0x3F0, 7);
+
+    // 0x3F0 + ('~' - 32) passes tile 0x3FF and wraps within 10 bits,
+    // leaving palette 7 and the priority and flip bits alone
+    text::putchar('~');
+    text::print_u16(12);
+
+    ASSERT_EQ(text::g_shadow[0], ((0x3F0 + 94) & 0x3FF) | (7 << 10));
+    ASSERT_EQ(text::g_shadow[1], ((0x3F0 + 17) & 0x3FF) | (7 << 10));
+    ASSERT_EQ(text::g_shadow[2], ((0x3F0 + 18) & 0x3FF) | (7 << 10));
+}
+
+TEST(text_flush_sends_dirty_row) {
+    TextTestFixture f;
+
+    text::set_cursor(0, 3);
+    text::puts("HI");
+    u16 sent = text::flush();
+
+    ASSERT_EQ(sent, text::SCREEN_COLS * 2);
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADD::address, 0x1000 + 3 * text::SCREEN_COLS));
+    ASSERT_TRUE(f.fake.wrote16(reg::DMA<0>::SIZE::address, text::SCREEN_COLS * 2));
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+    ASSERT_EQ(text::g_dirty_rows, 0u);
+}
+
+TEST(text_flush_merges_adjacent_rows) {
+    TextTestFixture f;
+
+    text::set_cursor(0, 1);
+    text::puts("A\nB\nC");
+    text::set_cursor(0, 10);
+    text::putchar('D');
+    u16 sent = text::flush();
+
+    // Rows 1-3 in one transfer, row 10 in another
+    ASSERT_EQ(sent, 4 * text::SCREEN_COLS * 2);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADD::address, 0x1000 + 1 * text::SCREEN_COLS));
+    ASSERT_TRUE(f.fake.wrote16(reg::DMA<0>::SIZE::address, 3 * text::SCREEN_COLS * 2));
+    ASSERT_TRUE(f.fake.wrote16(reg::VMADD::address, 0x1000 + 10 * text::SCREEN_COLS));
+}
+
+TEST(text_flush_idle_does_nothing) {
+    TextTestFixture f;
+
+    ASSERT_EQ(text::flush(), 0);
+    ASSERT_EQ(f.fake.write_count, 0);
+}
+
+TEST(text_clear_fills_by_dma) {
+    TextTestFixture f;
+
+    text::puts("SCORE");
+    text::clear();
+
+    ASSERT_EQ(text::g_shadow[0], 0x20 + (1 << 10));
+    ASSERT_EQ(text::g_dirty_rows, 0u);
+    ASSERT_EQ(f.fake.write_count, 0);
+
+    u16 sent = text::flush();
+
+    // Low and high bytes each take one fixed-source pass
+    ASSERT_EQ(sent, text::SCREEN_COLS * text::SCREEN_ROWS * 2);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 2);
+    ASSERT_TRUE(f.fake.wrote(reg::VMAIN::address, 0x00));
+    ASSERT_TRUE(f.fake.wrote(reg::VMAIN::address, 0x80));
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<0>::DEST::address, 0x18));
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<0>::DEST::address, 0x19));
+    ASSERT_EQ(f.fake.count_writes(reg::VMDATAL::address), 0);
+}
+
+TEST(text_flush_respects_budget) {
+    TextTestFixture f;
+
+    // Dirty rows 0-9: 640 bytes
+    for (u8 i = 0; i < 10; i++) {
+        text::set_cursor(0, i);
+        text::putchar('Z');
+    }
+
+    // Four rows fit in 300 bytes; the rest wait for the next flush
+    ASSERT_EQ(text::flush(300), 4 * text::ROW_BYTES);
+    ASSERT_EQ(text::g_dirty_rows, 0x3F0u);
+    ASSERT_EQ(text::flush(300), 4 * text::ROW_BYTES);
+    ASSERT_EQ(text::flush(300), 2 * text::ROW_BYTES);
+    ASSERT_EQ(text::g_dirty_rows, 0u);
+}
+
+TEST(text_flush_clear_comes_first) {
+    TextTestFixture f;
+
+    text::clear();
+    text::puts("HELLO");
+
+    // The clear fills the budget; row 0 follows on the next flush
+    ASSERT_EQ(text::flush(text::SCREEN_BYTES), text::SCREEN_BYTES);
+    ASSERT_EQ(text::g_dirty_rows, 1u);
+    ASSERT_EQ(text::flush(text::SCREEN_BYTES), text::ROW_BYTES);
+}
+
+TEST(text_flush_uses_gpdma_channel) {
+    TextTestFixture f;
+    while (dma::g_channels.claim_hdma() != dma::NO_CHANNEL) {}
+
+    text::clear();
+    text::putchar('A');
+    text::flush();
+
+    // Every HDMA channel is claimed; the flush stays on the reserved one
+    ASSERT_TRUE(f.fake.wrote(reg::DMA<0>::DEST::address, 0x19));
+    ASSERT_EQ(f.fake.last_write(reg::MDMAEN::address), 0x01);
+    dma::g_channels.reset();
+}
+
+TEST(text_install_flush_runs_in_nmi) {
+    TextTestFixture f;
+
+    ASSERT_TRUE(text::install_flush());
+    text::putchar('X');
+    vblank::dispatch();
+
+    ASSERT_EQ(text::g_dirty_rows, 0u);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+
+    text::uninstall_flush();
+    vblank::clear_hooks();
+}
+
+TEST(text_nmi_flush_waits_for_update) {
+    TextTestFixture f;
+
+    ASSERT_TRUE(text::install_flush());
+    text::putchar('X');
+
+    // NMI lands inside putchar(): nothing is sent and the row stays dirty
+    text::g_updating = true;
+    vblank::dispatch();
+    ASSERT_EQ(text::g_dirty_rows, 1u);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 0);
+
+    text::g_updating = false;
+    vblank::dispatch();
+    ASSERT_EQ(text::g_dirty_rows, 0u);
+    ASSERT_EQ(f.fake.count_writes(reg::MDMAEN::address), 1);
+
+    text::uninstall_flush();
+    vblank::clear_hooks();
+}
+
+// Shadow row 0 as a string, stripped of palette bits and font base
+static void text_row_string(char* out, u8 length) {
+    for (u8 i = 0; i < length; i++) {
+        out[i] = static_cast<char>((text::g_shadow[i] & 0x3FF) - 0x20 + 32);
+    }
+    out[length] = '\0';
+}
+
+TEST(text_format_u16_digits) {
+    char digits[5];
+
+    ASSERT_EQ(text::format_u16(0, digits), 1);
+    ASSERT_EQ(digits[4], '0');
+    ASSERT_EQ(text::format_u16(42, digits), 2);
+    ASSERT_EQ(digits[0], '0');
+    ASSERT_EQ(digits[3], '4');
+    ASSERT_EQ(digits[4], '2');
+    ASSERT_EQ(text::format_u16(65535, digits), 5);
+    ASSERT_EQ(digits[0], '6');
+    ASSERT_EQ(digits[4], '5');
+    ASSERT_EQ(text::format_u16(10000, digits), 5);
+    ASSERT_EQ(digits[1], '0');
+}
+
+TEST(text_print_numbers) {
+    TextTestFixture f;
+    char row[16];
+
+    text::print_u16(1234);
+    text::putchar(' ');
+    text::print_i16(-32768);
+    text::putchar(' ');
+    text::print_u16(0);
+    text_row_string(row, 14);
+
+    ASSERT_TRUE(std::strcmp(row, "1234 -32768 0 ") == 0);
+}
+
+TEST(text_print_fixed_width) {
+    TextTestFixture f;
+    char row[24];
+
+    text::print_u16(42, 5);
+    text::print_u16(42, 5, '0');
+    text::print_i16(-7, 4, '0');
+    text::print_i16(-7, 3);
+    text::print_u16(12345, 2);  // Too wide: printed in full
+    text_row_string(row, 22);
+
+    ASSERT_TRUE(std::strcmp(row, "   4200042-007 -712345") == 0);
+}
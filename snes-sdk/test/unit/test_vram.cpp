@@ -0,0 +1,105 @@
+// Unit tests for the VRAM region allocator
+#ifndef SNES_TESTING
+#define SNES_TESTING
+#endif
+#include "test_framework.hpp"
+#include <snes/vram.hpp>
+
+using namespace snes;
+
+TEST(vram_alignment_per_kind) {
+    vram::Allocator a;
+    a.reset();
+
+    u8 map = a.acquire(vram::kind::TILEMAP, 0x400);
+    u8 tiles = a.acquire(vram::kind::BG_TILES, 0x1800);
+    u8 obj = a.acquire(vram::kind::OBJ_TILES, 0x2000);
+
+    // Tilemaps from the top, tiles from the bottom
+    ASSERT_EQ(a.address(map), 0x7C00);
+    ASSERT_EQ(a.address(tiles), 0x0000);
+    ASSERT_EQ(a.words(tiles), 0x1800);
+    ASSERT_EQ(a.address(obj), 0x2000);
+
+    u8 tiles2 = a.acquire(vram::kind::BG_TILES, 0x1000);
+    ASSERT_EQ(a.address(tiles2) & 0x0FFF, 0);
+    ASSERT_EQ(a.address(tiles2), 0x4000);
+}
+
+TEST(vram_shared_key_refcount) {
+    vram::Allocator a;
+    a.reset();
+
+    u8 first = a.acquire(vram::kind::BG_TILES, 0x1000, 42);
+    a.mark_loaded(first);
+    u8 second = a.acquire(vram::kind::BG_TILES, 0x1000, 42);
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(a.regions[first].refs, 2);
+    ASSERT_TRUE(a.loaded(second));
+
+    a.release(first);
+    a.release(second);
+
+    // Cached: still resident and loaded
+    ASSERT_EQ(a.find(42), first);
+    ASSERT_EQ(a.stats().cached_pages, 4);
+    u8 again = a.acquire(vram::kind::BG_TILES, 0x1000, 42);
+    ASSERT_EQ(again, first);
+    ASSERT_TRUE(a.loaded(again));
+}
+
+TEST(vram_private_region_freed_on_release) {
+    vram::Allocator a;
+    a.reset();
+
+    u8 h = a.acquire(vram::kind::TILEMAP, 0x800);
+    ASSERT_EQ(a.stats().free_pages, 30);
+    a.release(h);
+    ASSERT_EQ(a.stats().free_pages, 32);
+    ASSERT_EQ(a.stats().cached_pages, 0);
+}
+
+TEST(vram_evicts_cached_when_full) {
+    vram::Allocator a;
+    a.reset();
+
+    for (u16 key = 1; key <= 4; key++) {
+        u8 h = a.acquire(vram::kind::OBJ_TILES, 0x2000, key);
+        ASSERT_NE(h, vram::NO_REGION);
+        if (key <= 2) a.release(h);
+    }
+    ASSERT_EQ(a.stats().free_pages, 0);
+
+    // Only room after evicting key 1
+    u8 h = a.acquire(vram::kind::BG_TILES, 0x2000, 9);
+    ASSERT_NE(h, vram::NO_REGION);
+    ASSERT_EQ(a.find(1), vram::NO_REGION);
+    ASSERT_NE(a.find(2), vram::NO_REGION);
+    ASSERT_FALSE(a.loaded(h));
+
+    // Live regions are never evicted
+    a.release(a.find(2));
+    a.flush_cache();
+    ASSERT_EQ(a.acquire(vram::kind::OBJ_TILES, 0x4000), vram::NO_REGION);
+}
+
+TEST(vram_fragmentation_stats) {
+    vram::Allocator a;
+    a.reset();
+
+    vram::Stats s = a.stats();
+    ASSERT_EQ(s.free_runs, 1);
+    ASSERT_EQ(s.largest_free, 32);
+
+    u8 t0 = a.acquire(vram::kind::BG_TILES, 0x1000);
+    u8 t1 = a.acquire(vram::kind::BG_TILES, 0x1000);
+    a.acquire(vram::kind::BG_TILES, 0x1000);
+    a.release(t1);
+    (void)t0;
+
+    s = a.stats();
+    ASSERT_EQ(s.free_pages, 24);
+    ASSERT_EQ(s.free_runs, 2);
+    ASSERT_EQ(s.largest_free, 20);
+}
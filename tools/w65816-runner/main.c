@@ -15,6 +15,7 @@
 #define ROM_START   0x8000    // Code loaded here
 #define RESULT_ADDR 0x0000    // Test result stored here
 #define MAX_CYCLES  10000000  // Cycle limit (10M)
+#define MAX_LOADS   8         // --load files per run
 
 static void print_usage(const char *prog) {
     fprintf(stderr, "Usage: %s [options] <binary>\n", prog);
@@ -25,9 +26,39 @@ static void print_usage(const char *prog) {
     fprintf(stderr, "  -d, --debug            Debug output (show CPU state)\n");
     fprintf(stderr, "  -c, --cycles <limit>   Cycle limit (default: %d)\n", MAX_CYCLES);
     fprintf(stderr, "  -o, --org <addr>       Load address (default: 0x%04X)\n", ROM_START);
+    fprintf(stderr, "  -l, --load <file>@<a>  Also load a data file at address a before running\n");
+    fprintf(stderr, "                         (e.g. a recorded joypad stream into the replay\n");
+    fprintf(stderr, "                         buffer, see snes-sdk/include/snes/input.hpp)\n");
     fprintf(stderr, "  -h, --help             Show this help\n");
 }
 
+// Copy a file into memory at addr; returns the byte count or -1
+static long load_file(memory_t *mem, const char *path, uint16_t addr) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot open '%s'\n", path);
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (size > MEM_SIZE - addr) {
+        fprintf(stderr, "Error: '%s' too large for $%04X (%zu bytes)\n", path, addr, size);
+        fclose(f);
+        return -1;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        int c = fgetc(f);
+        if (c == EOF) break;
+        mem[addr + i].val = (uint8_t)c;
+    }
+    fclose(f);
+    return (long)size;
+}
+
 static void print_cpu_state(CPU_t *cpu) {
     printf("  A=%04X X=%04X Y=%04X SP=%04X D=%04X PC=%02X:%04X\n",
            cpu->C, cpu->X, cpu->Y, cpu->SP, cpu->D, cpu->PBR, cpu->PC);
@@ -50,6 +81,9 @@ int main(int argc, char **argv) {
     uint64_t cycle_limit = MAX_CYCLES;
     uint16_t load_addr = ROM_START;
     uint16_t result_addr = RESULT_ADDR;
+    const char *load_files[MAX_LOADS];
+    uint16_t load_addrs[MAX_LOADS];
+    int load_count = 0;
 
     static struct option long_options[] = {
         {"expect",      required_argument, 0, 'e'},
@@ -58,12 +92,13 @@ int main(int argc, char **argv) {
         {"debug",       no_argument,       0, 'd'},
         {"cycles",      required_argument, 0, 'c'},
         {"org",         required_argument, 0, 'o'},
+        {"load",        required_argument, 0, 'l'},
         {"help",        no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
 
     int opt;
-    while ((opt = getopt_long(argc, argv, "e:r:vdc:o:h", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "e:r:vdc:o:l:h", long_options, NULL)) != -1) {
         switch (opt) {
             case 'e':
                 expected = (int)strtol(optarg, NULL, 0);
@@ -84,6 +119,19 @@ int main(int argc, char **argv) {
             case 'o':
                 load_addr = (uint16_t)strtol(optarg, NULL, 0);
                 break;
+            case 'l': {
+                char *at = strrchr(optarg, '@');
+                if (!at || at == optarg || load_count == MAX_LOADS) {
+                    fprintf(stderr, "Error: Bad --load '%s' (file@addr, at most %d)\n",
+                            optarg, MAX_LOADS);
+                    return 1;
+                }
+                *at = '\0';
+                load_files[load_count] = optarg;
+                load_addrs[load_count] = (uint16_t)strtol(at + 1, NULL, 0);
+                load_count++;
+                break;
+            }
             case 'h':
             default:
                 print_usage(argv[0]);
@@ -107,33 +155,26 @@ int main(int argc, char **argv) {
     }
 
     // Load binary
-    FILE *f = fopen(binary_file, "rb");
-    if (!f) {
-        fprintf(stderr, "Error: Cannot open '%s'\n", binary_file);
-        free(mem);
-        return 1;
-    }
-
-    fseek(f, 0, SEEK_END);
-    size_t size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-
-    if (size > MEM_SIZE - load_addr) {
-        fprintf(stderr, "Error: Binary too large (%zu bytes)\n", size);
-        fclose(f);
+    long size = load_file(mem, binary_file, load_addr);
+    if (size < 0) {
         free(mem);
         return 1;
     }
 
-    for (size_t i = 0; i < size; i++) {
-        int c = fgetc(f);
-        if (c == EOF) break;
-        mem[load_addr + i].val = (uint8_t)c;
+    if (verbose) {
+        printf("Loaded %ld bytes at $%04X from '%s'\n", size, load_addr, binary_file);
     }
-    fclose(f);
 
-    if (verbose) {
-        printf("Loaded %zu bytes at $%04X from '%s'\n", size, load_addr, binary_file);
+    // Data files go in after the binary, so they can fill buffers in it
+    for (int i = 0; i < load_count; i++) {
+        long n = load_file(mem, load_files[i], load_addrs[i]);
+        if (n < 0) {
+            free(mem);
+            return 1;
+        }
+        if (verbose) {
+            printf("Loaded %ld bytes at $%04X from '%s'\n", n, load_addrs[i], load_files[i]);
+        }
     }
 
     // Set reset vector to load address